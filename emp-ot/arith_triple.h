@@ -0,0 +1,161 @@
+#ifndef OT_ARITH_TRIPLE_H__
+#define OT_ARITH_TRIPLE_H__
+#include "emp-ot/shextension.h"
+#include <thread>
+#include <vector>
+/** @addtogroup OT
+  @{
+ */
+namespace emp {
+/*
+ * Beaver triples over Z_2^k, k = 8*sizeof(T) for T = uint32_t, uint64_t or
+ * unsigned __int128. Each party samples (a, b) and ends with c such that
+ * (a0+a1)*(b0+b1) = c0+c1 mod 2^k. The cross terms a0*b1 and a1*b0 are
+ * computed with Gilboa's multiplication: one COT per bit of the multiplier,
+ * with correlation m1 = m0 + (a << j), in both directions.
+ *
+ * In the multithreaded mode every thread owns one IO channel and a pair of
+ * OT extensions on it, and handles a contiguous slice of the triples.
+ */
+template<typename IO, typename T>
+class ArithTriple { public:
+	const static int k = sizeof(T)*8;
+	const static int batch = (1<<20)/k;
+	int party, threads;
+	IO ** ios;
+	SHOTExtension<IO> ** ot_send, ** ot_recv;
+	PRG * prgs;
+	bool own_ios = false;
+
+	ArithTriple(IO ** ios, int threads, int party) {
+		init(ios, threads, party);
+	}
+
+	ArithTriple(IO * io, int party) {
+		IO ** ios = new IO*[1];
+		ios[0] = io;
+		own_ios = true;
+		init(ios, 1, party);
+	}
+
+	void init(IO ** ios, int threads, int party) {
+		this->ios = ios;
+		this->threads = threads;
+		this->party = party;
+		ot_send = new SHOTExtension<IO>*[threads];
+		ot_recv = new SHOTExtension<IO>*[threads];
+		prgs = new PRG[threads];
+		for (int i = 0; i < threads; ++i) {
+			ot_send[i] = new SHOTExtension<IO>(ios[i]);
+			ot_recv[i] = new SHOTExtension<IO>(ios[i]);
+		}
+	}
+
+	~ArithTriple() {
+		for (int i = 0; i < threads; ++i) {
+			delete ot_send[i];
+			delete ot_recv[i];
+		}
+		delete[] ot_send;
+		delete[] ot_recv;
+		delete[] prgs;
+		if (own_ios)
+			delete[] ios;
+	}
+
+	static T from_block(const block & m) {
+		T v;
+		memcpy(&v, &m, sizeof(T));
+		return v;
+	}
+
+	static block to_block(const T & v) {
+		block m = zero_block();
+		memcpy(&m, &v, sizeof(T));
+		return m;
+	}
+
+	static block add_lanes(const block & x, const block & y) {
+		return sizeof(T) == 4 ? _mm_add_epi32(x, y) : _mm_add_epi64(x, y);
+	}
+
+	// sum of the low k bits of k consecutive blocks
+	static T accumulate(const block * m) {
+		if (sizeof(T) > 8) {
+			T s = 0;
+			for (int j = 0; j < k; ++j)
+				s += from_block(m[j]);
+			return s;
+		}
+		block acc[4] = {zero_block(), zero_block(), zero_block(), zero_block()};
+		for (int j = 0; j < k; j += 4) {
+			acc[0] = add_lanes(acc[0], m[j]);
+			acc[1] = add_lanes(acc[1], m[j+1]);
+			acc[2] = add_lanes(acc[2], m[j+2]);
+			acc[3] = add_lanes(acc[3], m[j+3]);
+		}
+		return from_block(add_lanes(add_lanes(acc[0], acc[1]), add_lanes(acc[2], acc[3])));
+	}
+
+	// out[i] -= share of a[i]*b[i], with b held by the other party
+	void mult_send(int tid, const T * a, T * out, block * m, int n) {
+		auto f = [a](block m0, uint64_t i) {
+			return to_block(from_block(m0) + (a[i/k] << (i%k)));
+		};
+		ot_send[tid]->send_cot_ft(m, f, n*k);
+		for (int i = 0; i < n; ++i)
+			out[i] -= accumulate(m + (int64_t)i*k);
+	}
+
+	// out[i] += share of a[i]*b[i], with a held by the other party
+	void mult_recv(int tid, const T * b, T * out, block * m, bool * bits, int n) {
+		for (int i = 0; i < n; ++i)
+			for (int j = 0; j < k; ++j)
+				bits[i*k+j] = (b[i] >> j) & 1;
+		ot_recv[tid]->recv_cot(m, bits, n*k);
+		for (int i = 0; i < n; ++i)
+			out[i] += accumulate(m + (int64_t)i*k);
+	}
+
+	void generate_thread(int tid, T * a, T * b, T * c, int64_t n) {
+		block * m = new block[batch*k];
+		bool * bits = new bool[batch*k];
+		for (int64_t i = 0; i < n; i += batch) {
+			int len = min((int64_t)batch, n - i);
+			prgs[tid].random_data(a+i, len*sizeof(T));
+			prgs[tid].random_data(b+i, len*sizeof(T));
+			for (int j = 0; j < len; ++j)
+				c[i+j] = a[i+j] * b[i+j];
+			if (party == ALICE) {
+				mult_send(tid, a+i, c+i, m, len);
+				mult_recv(tid, b+i, c+i, m, bits, len);
+			} else {
+				mult_recv(tid, b+i, c+i, m, bits, len);
+				mult_send(tid, a+i, c+i, m, len);
+			}
+		}
+		ios[tid]->flush();
+		delete[] m;
+		delete[] bits;
+	}
+
+	// fills a, b, c with this party's shares of n fresh triples
+	void generate(T * a, T * b, T * c, int64_t n) {
+		if (threads == 1) {
+			generate_thread(0, a, b, c, n);
+			return;
+		}
+		std::vector<std::thread> workers;
+		int64_t width = (n + threads - 1) / threads;
+		for (int tid = 0; tid < threads; ++tid) {
+			int64_t start = min(n, tid * width), len = min(width, n - start);
+			workers.push_back(std::thread(&ArithTriple::generate_thread, this, tid,
+				a+start, b+start, c+start, len));
+		}
+		for (auto & t : workers)
+			t.join();
+	}
+};
+/**@}*/
+}
+#endif// OT_ARITH_TRIPLE_H__
@@ -0,0 +1,72 @@
+#ifndef OT_BIT_TRIPLE_H__
+#define OT_BIT_TRIPLE_H__
+#include <emp-tool/emp-tool.h>
+/** @addtogroup OT
+  @{
+ */
+namespace emp {
+/*
+ * Boolean AND triples from two random bit-OTs per triple, one in each
+ * direction. If a party is the ROT sender of (x0, x1) and the ROT receiver of
+ * y with choice bit r, its triple share is a = x0^x1, b = r and
+ * c = (a & b) ^ x0 ^ y, so that (a0^a1) & (b0^b1) = c0^c1.
+ *
+ * Shares are bit-packed: bit i%64 of word i/64 belongs to triple i. Triples
+ * are produced `chunk` at a time, so memory stays bounded for any n.
+ */
+template<typename IO, template<typename> class OTE>
+class BitTripleGen { public:
+	const static int chunk = 1<<22;
+	OTE<IO> * ot_send = nullptr, * ot_recv = nullptr;
+	int party;
+	PRG prg;
+	bool * choice = nullptr;
+	uint64_t * x0 = nullptr, * x1 = nullptr, * y = nullptr;
+
+	BitTripleGen(IO * io, int party) {
+		this->party = party;
+		ot_send = new OTE<IO>(io);
+		ot_recv = new OTE<IO>(io);
+		choice = new bool[chunk];
+		x0 = new uint64_t[chunk/64];
+		x1 = new uint64_t[chunk/64];
+		y = new uint64_t[chunk/64];
+	}
+
+	~BitTripleGen() {
+		delete ot_send;
+		delete ot_recv;
+		delete[] choice;
+		delete[] x0;
+		delete[] x1;
+		delete[] y;
+	}
+
+	// a, b and c hold (n+63)/64 words each
+	void generate(uint64_t * a, uint64_t * b, uint64_t * c, int64_t n) {
+		for (int64_t i = 0; i < n; i += chunk) {
+			int len = min((int64_t)chunk, n - i);
+			int words = (len + 63) / 64;
+			prg.random_bool(choice, len);
+			if (party == ALICE) {
+				ot_send->send_rot_bits(x0, x1, len);
+				ot_recv->recv_rot_bits(y, choice, len);
+			} else {
+				ot_recv->recv_rot_bits(y, choice, len);
+				ot_send->send_rot_bits(x0, x1, len);
+			}
+			uint64_t * aw = a + i/64, * bw = b + i/64, * cw = c + i/64;
+			for (int w = 0; w < words; ++w) {
+				uint64_t r = 0;
+				for (int j = 0; j < 64 and w*64+j < len; ++j)
+					r |= (uint64_t)choice[w*64+j] << j;
+				aw[w] = x0[w] ^ x1[w];
+				bw[w] = r;
+				cw[w] = (aw[w] & r) ^ x0[w] ^ y[w];
+			}
+		}
+	}
+};
+/**@}*/
+}
+#endif// OT_BIT_TRIPLE_H__
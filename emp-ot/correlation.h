@@ -0,0 +1,114 @@
+#ifndef OT_CORRELATION_H__
+#define OT_CORRELATION_H__
+#include <emp-tool/emp-tool.h>
+#include <immintrin.h>
+/** @addtogroup OT
+  @{
+ */
+namespace emp {
+/*
+ * Batch correlation policies for send_cot_p. A policy is any callable
+ *     void operator()(block * m1, const block * m0, int64_t start, int n) const
+ * that writes the 1-messages of OTs start..start+n from their 0-messages.
+ * The extension calls it once per AES batch, so policies can vectorize over
+ * the whole span; a lambda with this signature works as well.
+ *
+ * The built-in policies take either one delta for every OT or a per-OT
+ * array indexed by the OT number.
+ */
+class XorCorrelation { public:
+	const block * deltas = nullptr;
+	block delta = zero_block();
+	XorCorrelation(block delta) : delta(delta) {}
+	XorCorrelation(const block * deltas) : deltas(deltas) {}
+
+	void operator()(block * m1, const block * m0, int64_t start, int n) const {
+		int j = 0;
+		if (deltas == nullptr) {
+			for (; j < n; ++j)
+				m1[j] = xorBlocks(m0[j], delta);
+			return;
+		}
+		const block * d = deltas + start;
+#ifdef __AVX2__
+		for (; j + 2 <= n; j += 2) {
+			__m256i x = _mm256_loadu_si256((const __m256i *)(m0 + j));
+			__m256i y = _mm256_loadu_si256((const __m256i *)(d + j));
+			_mm256_storeu_si256((__m256i *)(m1 + j), _mm256_xor_si256(x, y));
+		}
+#endif
+		for (; j < n; ++j)
+			m1[j] = xorBlocks(m0[j], d[j]);
+	}
+};
+
+// lane-wise addition in Z_2^32 (four lanes) or Z_2^64 (two lanes)
+template<typename T>
+class AddCorrelation { public:
+	static_assert(sizeof(T) == 4 or sizeof(T) == 8, "AddCorrelation lanes are 32 or 64 bits");
+	const block * deltas = nullptr;
+	block delta = zero_block();
+	AddCorrelation(block delta) : delta(delta) {}
+	AddCorrelation(const block * deltas) : deltas(deltas) {}
+
+	static block add(const block & x, const block & y) {
+		return sizeof(T) == 4 ? _mm_add_epi32(x, y) : _mm_add_epi64(x, y);
+	}
+
+#ifdef __AVX2__
+	static __m256i add(const __m256i & x, const __m256i & y) {
+		return sizeof(T) == 4 ? _mm256_add_epi32(x, y) : _mm256_add_epi64(x, y);
+	}
+#endif
+
+	void operator()(block * m1, const block * m0, int64_t start, int n) const {
+		int j = 0;
+		const block * d = deltas == nullptr ? nullptr : deltas + start;
+#ifdef __AVX2__
+		__m256i vd = _mm256_broadcastsi128_si256(delta);
+		for (; j + 2 <= n; j += 2) {
+			__m256i x = _mm256_loadu_si256((const __m256i *)(m0 + j));
+			__m256i y = d == nullptr ? vd : _mm256_loadu_si256((const __m256i *)(d + j));
+			_mm256_storeu_si256((__m256i *)(m1 + j), add(x, y));
+		}
+#endif
+		for (; j < n; ++j)
+			m1[j] = add(m0[j], d == nullptr ? delta : d[j]);
+	}
+};
+
+// m1 = a * m0 + b on both 64-bit lanes, mod 2^64
+class AffineCorrelation { public:
+	uint64_t a;
+	const block * bs = nullptr;
+	block b;
+	AffineCorrelation(uint64_t a, block b) : a(a), b(b) {}
+	AffineCorrelation(uint64_t a, const block * bs) : a(a), bs(bs) {}
+
+	void operator()(block * m1, const block * m0, int64_t start, int n) const {
+		int j = 0;
+		const block * d = bs == nullptr ? nullptr : bs + start;
+#ifdef __AVX2__
+		const __m256i va = _mm256_set1_epi64x(a);
+		const __m256i va_hi = _mm256_srli_epi64(va, 32);
+		const __m256i vb = _mm256_broadcastsi128_si256(b);
+		for (; j + 2 <= n; j += 2) {
+			__m256i x = _mm256_loadu_si256((const __m256i *)(m0 + j));
+			__m256i lo = _mm256_mul_epu32(x, va);
+			__m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), va),
+					_mm256_mul_epu32(x, va_hi));
+			__m256i y = d == nullptr ? vb : _mm256_loadu_si256((const __m256i *)(d + j));
+			x = _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+			_mm256_storeu_si256((__m256i *)(m1 + j), _mm256_add_epi64(x, y));
+		}
+#endif
+		for (; j < n; ++j) {
+			block y = d == nullptr ? b : d[j];
+			m1[j] = makeBlock(a * (uint64_t)m0[j][1] + (uint64_t)y[1],
+					a * (uint64_t)m0[j][0] + (uint64_t)y[0]);
+		}
+	}
+};
+/**@}*/
+}
+#endif// OT_CORRELATION_H__
@@ -0,0 +1,149 @@
+#ifndef OT_COT_GENERATOR_H__
+#define OT_COT_GENERATOR_H__
+#include <emp-tool/emp-tool.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+/** @addtogroup OT
+  @{
+ */
+namespace emp {
+/*
+ * Pull-based COT source. COTs are handed out of a front buffer while a
+ * background thread fills a back buffer with one large extension call of
+ * `high` COTs; a refill starts once fewer than `low` COTs are left in front.
+ *
+ * The generator owns `io` for its whole lifetime. Refills are triggered only
+ * by consumption, so both parties stay in step as long as their next() calls
+ * request the same amounts, which is the case for any protocol that consumes
+ * COTs pairwise. ALICE is the COT sender and holds `delta`.
+ */
+template<typename IO, template<typename> class OTE>
+class COTGenerator { public:
+	OTE<IO> * ot = nullptr;
+	IO * io = nullptr;
+	int party;
+	int64_t low, high;
+	block delta;
+	PRG prg;
+
+	block * buf[2];
+	bool * bits[2] = {nullptr, nullptr};
+	int front = 0;
+	int64_t pos = 0;
+	bool refilling = false, back_ready = false, stop = false;
+	std::mutex mtx;
+	std::condition_variable cv;
+	std::thread worker;
+
+	COTGenerator(IO * io, int party, int64_t low = 1<<20, int64_t high = 1<<22) {
+		this->io = io;
+		this->party = party;
+		this->low = low;
+		this->high = high;
+		if (low > high)
+			error("COTGenerator: low watermark above high watermark");
+		prg.random_block(&delta, 1);
+		ot = new OTE<IO>(io);
+		for (int i = 0; i < 2; ++i) {
+			buf[i] = new block[high];
+			if (party != ALICE)
+				bits[i] = new bool[high];
+		}
+		refill(front);
+		worker = std::thread(&COTGenerator::run, this);
+		check_watermark();
+	}
+
+	~COTGenerator() {
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			stop = true;
+		}
+		cv.notify_all();
+		worker.join();
+		delete ot;
+		for (int i = 0; i < 2; ++i) {
+			delete[] buf[i];
+			delete_array_null(bits[i]);
+		}
+	}
+
+	void refill(int idx) {
+		if (party == ALICE) {
+			ot->send_cot(buf[idx], delta, high);
+		} else {
+			prg.random_bool(bits[idx], high);
+			ot->recv_cot(buf[idx], bits[idx], high);
+		}
+		io->flush();
+	}
+
+	void run() {
+		while (true) {
+			std::unique_lock<std::mutex> lock(mtx);
+			cv.wait(lock, [this]{ return stop or (refilling and !back_ready); });
+			if (stop and !(refilling and !back_ready))
+				return;
+			lock.unlock();
+			refill(1 - front);
+			lock.lock();
+			back_ready = true;
+			refilling = false;
+			lock.unlock();
+			cv.notify_all();
+		}
+	}
+
+	void check_watermark() {
+		if (high - pos < low) {
+			std::lock_guard<std::mutex> lock(mtx);
+			if (refilling or back_ready)
+				return;
+			refilling = true;
+		}
+		cv.notify_all();
+	}
+
+	void swap() {
+		std::unique_lock<std::mutex> lock(mtx);
+		if (!refilling and !back_ready) {
+			refilling = true;
+			cv.notify_all();
+		}
+		cv.wait(lock, [this]{ return back_ready; });
+		back_ready = false;
+		front = 1 - front;
+		pos = 0;
+	}
+
+	// receiver: data[i] is the b[i]-message
+	void next(block * data, bool * b, int64_t length) {
+		if (party != ALICE and b == nullptr)
+			error("COTGenerator: receiver needs choice bits");
+		if (party == ALICE)
+			b = nullptr;
+		while (length > 0) {
+			if (pos == high)
+				swap();
+			int64_t n = min(length, high - pos);
+			memcpy(data, buf[front] + pos, n * sizeof(block));
+			if (b != nullptr)
+				memcpy(b, bits[front] + pos, n);
+			pos += n;
+			data += n;
+			if (b != nullptr)
+				b += n;
+			length -= n;
+			check_watermark();
+		}
+	}
+
+	// sender: data[i] is the 0-message, data[i]^delta the 1-message
+	void next(block * data, int64_t length) {
+		next(data, nullptr, length);
+	}
+};
+/**@}*/
+}
+#endif// OT_COT_GENERATOR_H__
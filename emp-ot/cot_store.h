@@ -0,0 +1,252 @@
+#ifndef OT_COT_STORE_H__
+#define OT_COT_STORE_H__
+#include <emp-tool/emp-tool.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+/** @addtogroup OT
+  @{
+ */
+namespace emp {
+/*
+ * File layout: a 64-byte COTStoreHeader, then `capacity` records of
+ * `width` blocks each (2 for a ROT sender: (m0, m1), 1 otherwise), then,
+ * for receivers only, `capacity` choice bytes. `count` is the number of
+ * records written, `cursor` the number already handed out.
+ */
+enum COTStoreRole { COT_STORE_SEND_COT = 0, COT_STORE_RECV_COT = 1,
+	COT_STORE_SEND_ROT = 2, COT_STORE_RECV_ROT = 3 };
+
+struct COTStoreHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t role;
+	block delta;
+	uint64_t capacity;
+	uint64_t count;
+	uint64_t cursor;
+	uint64_t reserved;
+};
+
+const static char cot_store_magic[8] = {'E', 'M', 'P', 'C', 'O', 'T', 'S', '1'};
+const static uint32_t cot_store_version = 1;
+
+inline int cot_store_width(uint32_t role) {
+	return role == COT_STORE_SEND_ROT ? 2 : 1;
+}
+
+inline bool cot_store_has_choices(uint32_t role) {
+	return role == COT_STORE_RECV_COT or role == COT_STORE_RECV_ROT;
+}
+
+inline size_t cot_store_size(uint32_t role, uint64_t capacity) {
+	size_t size = sizeof(COTStoreHeader) + capacity * cot_store_width(role) * sizeof(block);
+	if (cot_store_has_choices(role))
+		size += capacity;
+	return size;
+}
+
+class COTStoreWriter { public:
+	int fd = -1, width;
+	COTStoreHeader header;
+	PRG prg;
+	COTStoreWriter(const char * file, COTStoreRole role, int64_t capacity, block delta = zero_block()) {
+		memset(&header, 0, sizeof(COTStoreHeader));
+		memcpy(header.magic, cot_store_magic, 8);
+		header.version = cot_store_version;
+		header.role = role;
+		header.delta = delta;
+		header.capacity = capacity;
+		width = cot_store_width(role);
+		fd = open(file, O_RDWR | O_CREAT | O_TRUNC, 0600);
+		if (fd < 0)
+			error("cannot create COT store");
+		if (ftruncate(fd, cot_store_size(role, capacity)) != 0)
+			error("cannot allocate COT store");
+		write_header();
+	}
+
+	~COTStoreWriter() {
+		close();
+	}
+
+	void write_header() {
+		if (pwrite(fd, &header, sizeof(COTStoreHeader), 0) != sizeof(COTStoreHeader))
+			error("cannot write COT store header");
+	}
+
+	void write_all(const void * data, size_t nbyte, off_t offset) {
+		const char * p = (const char *)data;
+		while (nbyte > 0) {
+			ssize_t res = pwrite(fd, p, nbyte, offset);
+			if (res <= 0)
+				error("cannot write COT store");
+			p += res;
+			nbyte -= res;
+			offset += res;
+		}
+	}
+
+	// data holds length*width blocks; b holds length choice bits for receivers
+	void write(const block * data, const bool * b, int64_t length) {
+		if (header.count + length > header.capacity)
+			error("COT store is full");
+		off_t offset = sizeof(COTStoreHeader) + header.count * width * sizeof(block);
+		write_all(data, length * width * sizeof(block), offset);
+		if (cot_store_has_choices(header.role)) {
+			offset = sizeof(COTStoreHeader) + header.capacity * width * sizeof(block) + header.count;
+			write_all(b, length, offset);
+		}
+		header.count += length;
+	}
+
+	void close() {
+		if (fd < 0) return;
+		write_header();
+		fsync(fd);
+		::close(fd);
+		fd = -1;
+	}
+
+	template<typename OTE>
+	void send_cot(OTE * ot, int64_t length, int chunk = 1<<20) {
+		block * data = new block[chunk];
+		for (int64_t i = 0; i < length; i += chunk) {
+			int n = min((int64_t)chunk, length - i);
+			ot->send_cot(data, header.delta, n);
+			write(data, nullptr, n);
+		}
+		delete[] data;
+	}
+
+	template<typename OTE>
+	void recv_cot(OTE * ot, int64_t length, int chunk = 1<<20) {
+		block * data = new block[chunk];
+		bool * b = new bool[chunk];
+		for (int64_t i = 0; i < length; i += chunk) {
+			int n = min((int64_t)chunk, length - i);
+			prg.random_bool(b, n);
+			ot->recv_cot(data, b, n);
+			write(data, b, n);
+		}
+		delete[] data;
+		delete[] b;
+	}
+
+	template<typename OTE>
+	void send_rot(OTE * ot, int64_t length, int chunk = 1<<20) {
+		block * data0 = new block[chunk];
+		block * data1 = new block[chunk];
+		block * data = new block[2*chunk];
+		for (int64_t i = 0; i < length; i += chunk) {
+			int n = min((int64_t)chunk, length - i);
+			ot->send_rot(data0, data1, n);
+			for (int j = 0; j < n; ++j) {
+				data[2*j] = data0[j];
+				data[2*j+1] = data1[j];
+			}
+			write(data, nullptr, n);
+		}
+		delete[] data0;
+		delete[] data1;
+		delete[] data;
+	}
+
+	template<typename OTE>
+	void recv_rot(OTE * ot, int64_t length, int chunk = 1<<20) {
+		block * data = new block[chunk];
+		bool * b = new bool[chunk];
+		for (int64_t i = 0; i < length; i += chunk) {
+			int n = min((int64_t)chunk, length - i);
+			prg.random_bool(b, n);
+			ot->recv_rot(data, b, n);
+			write(data, b, n);
+		}
+		delete[] data;
+		delete[] b;
+	}
+};
+
+/*
+ * Read side of a COT store. The file is mapped shared and the consumed
+ * cursor lives in the mapped header, so a range handed out by next() is
+ * never handed out again, also across restarts and across processes that
+ * map the same file.
+ */
+class COTStore { public:
+	int fd = -1, width;
+	size_t size = 0;
+	char * map = nullptr;
+	COTStoreHeader * header = nullptr;
+	block * records = nullptr;
+	bool * choices = nullptr;
+	COTStore(const char * file) {
+		fd = open(file, O_RDWR);
+		if (fd < 0)
+			error("cannot open COT store");
+		struct stat st;
+		if (fstat(fd, &st) != 0 or st.st_size < (off_t)sizeof(COTStoreHeader))
+			error("invalid COT store");
+		size = st.st_size;
+		map = (char *)mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if (map == MAP_FAILED)
+			error("cannot map COT store");
+		header = (COTStoreHeader *)map;
+		if (memcmp(header->magic, cot_store_magic, 8) != 0 or header->version != cot_store_version
+				or size != cot_store_size(header->role, header->capacity)
+				or header->count > header->capacity or header->cursor > header->count)
+			error("invalid COT store");
+		width = cot_store_width(header->role);
+		records = (block *)(map + sizeof(COTStoreHeader));
+		if (cot_store_has_choices(header->role))
+			choices = (bool *)(records + header->capacity * width);
+		madvise(records, header->count * width * sizeof(block), MADV_SEQUENTIAL);
+	}
+
+	~COTStore() {
+		if (map != nullptr) {
+			msync(map, sizeof(COTStoreHeader), MS_SYNC);
+			munmap(map, size);
+		}
+		if (fd >= 0)
+			close(fd);
+	}
+
+	COTStoreRole role() const {
+		return (COTStoreRole)header->role;
+	}
+
+	block delta() const {
+		return header->delta;
+	}
+
+	int64_t remaining() const {
+		return header->count - __atomic_load_n(&header->cursor, __ATOMIC_ACQUIRE);
+	}
+
+	/*
+	 * Hands out the next `length` records, `length*width` contiguous blocks,
+	 * and, for receivers, their choice bits through `b`. Returns nullptr when
+	 * fewer than `length` records are left. Safe to call from several threads.
+	 */
+	const block * next(int64_t length, const bool ** b = nullptr) {
+		uint64_t start = __atomic_load_n(&header->cursor, __ATOMIC_ACQUIRE);
+		do {
+			if (start + length > header->count)
+				return nullptr;
+		} while (!__atomic_compare_exchange_n(&header->cursor, &start, start + length,
+				true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+		if (b != nullptr)
+			*b = choices == nullptr ? nullptr : choices + start;
+		return records + start * width;
+	}
+
+	// forces the consumed cursor to disk
+	void sync() {
+		msync(map, sizeof(COTStoreHeader), MS_SYNC);
+	}
+};
+/**@}*/
+}
+#endif// OT_COT_STORE_H__
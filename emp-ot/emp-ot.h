@@ -20,10 +20,24 @@
 
 #include "emp-ot/shextension.h"
 #include "emp-ot/ot_extension.h"
+#include "emp-ot/correlation.h"
 #include "emp-ot/mextension_kos.h"
 #include "emp-ot/mextension_alsz.h"
+#include "emp-ot/nextension_kk.h"
+#include "emp-ot/oprf_kkrt.h"
 
 #include "emp-ot/deltaot.h"
+#include "emp-ot/tinyot.h"
+#include "emp-ot/cot_store.h"
+#include "emp-ot/cot_generator.h"
+#include "emp-ot/ot_coalescer.h"
+#include "emp-ot/long_ot.h"
+#include "emp-ot/arith_triple.h"
+#include "emp-ot/prime_ole.h"
+#include "emp-ot/bit_triple.h"
+#include "emp-ot/ggm.h"
+#include "emp-ot/silent_ot.h"
+#include "emp-ot/psi.h"
 
 template<typename IO>
 using MOTExtension = emp::MOTExtension_KOS<IO>;
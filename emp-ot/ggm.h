@@ -0,0 +1,246 @@
+#ifndef OT_GGM_H__
+#define OT_GGM_H__
+#include <emp-tool/emp-tool.h>
+#include <thread>
+#include <vector>
+/** @addtogroup OT
+  @{
+ */
+namespace emp {
+/*
+ * Batched GGM-tree single-point COT engine. Trees have 2^h leaves and are
+ * expanded in place, level by level across a group of trees, with fixed-key
+ * AES: the children of x are P0(x)^x and P1(x)^x.
+ *
+ * Tree j consumes h random OTs, index j*h+i for level i+1 (top level first).
+ * The sender masks the XOR of the even and of the odd nodes of each level
+ * with m0 and m1; the receiver, holding m_b, learns the sum on side b and so
+ * every node except its path, which takes child !b at each level. The
+ * punctured leaf alpha[j] therefore has bits !b, most significant first.
+ *
+ * With a delta, the sender also sends delta ^ (sum of leaves) and the
+ * receiver's leaf alpha becomes the sender's leaf ^ delta (an SPCOT);
+ * without, it is left zero (a punctured PRF). Trees are split across
+ * `threads` threads; all communication happens on the calling thread.
+ */
+class GGMSPCOT { public:
+	// trees expanded together: enough to fill the AES pipeline at the top
+	// levels while the group still fits in cache
+	const static int group = 8;
+	int h, threads;
+	PRP prp0, prp1;
+
+	GGMSPCOT(int h, int threads = 1) : prp0(makeBlock(0, 2)), prp1(makeBlock(0, 3)) {
+		this->h = h;
+		this->threads = threads;
+	}
+
+	int msg_size(bool with_delta) {
+		return 2*h + (with_delta ? 1 : 0);
+	}
+
+	void flush(block * parent, block ** dst, int n) {
+		block l[8], r[8];
+		for (int k = 0; k < n; ++k)
+			l[k] = r[k] = parent[k];
+		prp0.permute_block(l, 8);
+		prp1.permute_block(r, 8);
+		for (int k = 0; k < n; ++k) {
+			dst[k][0] = xorBlocks(l[k], parent[k]);
+			dst[k][1] = xorBlocks(r[k], parent[k]);
+		}
+	}
+
+	// level i-1 into level i of trees[0..n); parents are copied before their
+	// slots can be overwritten, so the expansion is in place
+	void expand_level(block * const * trees, int n, int i) {
+		block parent[8];
+		block * dst[8];
+		int cnt = 0;
+		for (int j = 0; j < n; ++j) {
+			for (int p = (1 << (i-1)) - 1; p >= 0; --p) {
+				parent[cnt] = trees[j][p];
+				dst[cnt] = trees[j] + 2*p;
+				if (++cnt == 8) {
+					flush(parent, dst, cnt);
+					cnt = 0;
+				}
+			}
+		}
+		if (cnt > 0)
+			flush(parent, dst, cnt);
+	}
+
+	template<typename F>
+	void parallel(int t, F f) {
+		if (threads <= 1 or t < 2) {
+			f(0, t);
+			return;
+		}
+		std::vector<std::thread> workers;
+		int width = (t + threads - 1) / threads;
+		for (int lo = 0; lo < t; lo += width)
+			workers.push_back(std::thread(f, lo, min(t, lo + width)));
+		for (auto & w : workers)
+			w.join();
+	}
+
+	void send_range(block * out, int lo, int hi, const block * seeds, const block * m0,
+			const block * m1, block * msg, const block * delta) {
+		const int ms = msg_size(delta != nullptr);
+		std::vector<block *> trees(hi - lo);
+		for (int j = lo; j < hi; ++j) {
+			trees[j-lo] = out + ((int64_t)j << h);
+			trees[j-lo][0] = seeds[j];
+		}
+		for (int i = 1; i <= h; ++i) {
+			expand_level(trees.data(), hi - lo, i);
+			for (int j = lo; j < hi; ++j) {
+				block s[2] = {zero_block(), zero_block()};
+				for (int x = 0; x < (1 << i); ++x)
+					s[x & 1] = xorBlocks(s[x & 1], trees[j-lo][x]);
+				int64_t k = (int64_t)j * h + i - 1;
+				msg[(int64_t)j * ms + 2*(i-1)] = xorBlocks(s[0], m0[k]);
+				msg[(int64_t)j * ms + 2*(i-1)+1] = xorBlocks(s[1], m1[k]);
+			}
+		}
+		if (delta == nullptr)
+			return;
+		for (int j = lo; j < hi; ++j) {
+			block psi = *delta;
+			for (int x = 0; x < (1 << h); ++x)
+				psi = xorBlocks(psi, trees[j-lo][x]);
+			msg[(int64_t)j * ms + 2*h] = psi;
+		}
+	}
+
+	void recv_range(block * out, int lo, int hi, const block * m, const bool * b,
+			const block * msg, int * alpha, bool with_delta) {
+		const int ms = msg_size(with_delta);
+		std::vector<block *> trees(hi - lo);
+		for (int j = lo; j < hi; ++j) {
+			trees[j-lo] = out + ((int64_t)j << h);
+			alpha[j] = 0;
+		}
+		for (int i = 1; i <= h; ++i) {
+			if (i > 1)
+				expand_level(trees.data(), hi - lo, i);
+			for (int j = lo; j < hi; ++j) {
+				block * tree = trees[j-lo];
+				int64_t k = (int64_t)j * h + i - 1;
+				int sibling = 2*alpha[j] + b[k];
+				alpha[j] = 2*alpha[j] + !b[k];
+				tree[sibling] = tree[alpha[j]] = zero_block();
+				block s = xorBlocks(msg[(int64_t)j * ms + 2*(i-1) + b[k]], m[k]);
+				for (int x = b[k]; x < (1 << i); x += 2)
+					s = xorBlocks(s, tree[x]);
+				tree[sibling] = s;
+			}
+		}
+		if (!with_delta)
+			return;
+		for (int j = lo; j < hi; ++j) {
+			block psi = msg[(int64_t)j * ms + 2*h];
+			for (int x = 0; x < (1 << h); ++x)
+				psi = xorBlocks(psi, trees[j-lo][x]);
+			trees[j-lo][alpha[j]] = psi;
+		}
+	}
+
+	// out holds t << h blocks; m0, m1 hold t*h random OTs
+	template<typename IO>
+	void send(IO * io, block * out, int t, const block * m0, const block * m1, PRG & prg,
+			const block * delta = nullptr) {
+		const int ms = msg_size(delta != nullptr);
+		block * seeds = new block[t];
+		block * msg = new block[(int64_t)t * ms];
+		prg.random_block(seeds, t);
+		parallel(t, [&](int lo, int hi) {
+			for (int g = lo; g < hi; g += group)
+				send_range(out, g, min(hi, g + group), seeds, m0, m1, msg, delta);
+		});
+		io->send_block(msg, (int64_t)t * ms);
+		io->flush();
+		delete[] seeds;
+		delete[] msg;
+	}
+
+	template<typename IO>
+	void recv(IO * io, block * out, int t, const block * m, const bool * b, int * alpha,
+			bool with_delta = false) {
+		const int ms = msg_size(with_delta);
+		block * msg = new block[(int64_t)t * ms];
+		io->recv_block(msg, (int64_t)t * ms);
+		parallel(t, [&](int lo, int hi) {
+			for (int g = lo; g < hi; g += group)
+				recv_range(out, g, min(hi, g + group), m, b, msg, alpha, with_delta);
+		});
+		delete[] msg;
+	}
+};
+
+/*
+ * Regular multi-point COT over SHOTExtension or MOTExtension_KOS random OTs:
+ * t trees of 2^h leaves, one punctured point per tree at a position chosen
+ * by the receiver. The receiver derandomizes its ROT choice bits with one
+ * flip bit per level.
+ */
+template<typename IO, template<typename> class OTE>
+class MPCOT { public:
+	IO * io = nullptr;
+	OTE<IO> * ot = nullptr;
+	GGMSPCOT spcot;
+	PRG prg;
+	int h;
+
+	MPCOT(IO * io, int h, int threads = 1) : spcot(h, threads) {
+		this->io = io;
+		this->h = h;
+		ot = new OTE<IO>(io);
+	}
+
+	~MPCOT() {
+		delete ot;
+	}
+
+	// out holds t << h leaves; with delta, the receiver gets leaf ^ delta at alpha
+	void send(block * out, int t, const block * delta = nullptr) {
+		int64_t n = (int64_t)t * h;
+		block * m0 = new block[n], * m1 = new block[n];
+		bool * flip = new bool[n];
+		ot->send_rot(m0, m1, n);
+		io->recv_data(flip, n);
+		for (int64_t k = 0; k < n; ++k)
+			if (flip[k])
+				std::swap(m0[k], m1[k]);
+		spcot.send(io, out, t, m0, m1, prg, delta);
+		delete[] m0;
+		delete[] m1;
+		delete[] flip;
+	}
+
+	// alpha[j] in [0, 2^h) is the punctured leaf of tree j
+	void recv(block * out, int t, const int * alpha, bool with_delta = false) {
+		int64_t n = (int64_t)t * h;
+		block * m = new block[n];
+		bool * b = new bool[n], * want = new bool[n];
+		int * path = new int[t];
+		prg.random_bool(b, n);
+		ot->recv_rot(m, b, n);
+		for (int j = 0; j < t; ++j)
+			for (int i = 0; i < h; ++i) {
+				want[(int64_t)j*h+i] = !((alpha[j] >> (h-1-i)) & 1);
+				b[(int64_t)j*h+i] ^= want[(int64_t)j*h+i];
+			}
+		io->send_data(b, n);
+		io->flush();
+		spcot.recv(io, out, t, m, want, path, with_delta);
+		delete[] m;
+		delete[] b;
+		delete[] want;
+		delete[] path;
+	}
+};
+/**@}*/
+}
+#endif// OT_GGM_H__
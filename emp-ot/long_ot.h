@@ -0,0 +1,111 @@
+#ifndef OT_LONG_OT_H__
+#define OT_LONG_OT_H__
+#include <emp-tool/emp-tool.h>
+/** @addtogroup OT
+  @{
+ */
+namespace emp {
+/*
+ * Chosen-message OT for byte strings of arbitrary length. One random OT is
+ * run per message pair and each of its two pads seeds a PRG stream that
+ * masks the whole payload, so the extension cost is independent of the
+ * message length.
+ *
+ * Messages are stored back to back in an arena: message i starts at the sum
+ * of lengths[0..i) and is lengths[i] bytes long, the same in data0, data1 and
+ * the receiver's output.
+ */
+template<typename IO, template<typename> class OTE>
+class LongOT { public:
+	const static int chunk = 1<<16;
+	OTE<IO> * ot = nullptr;
+	IO * io = nullptr;
+	PRG prg;
+	uint8_t * mask = nullptr;
+
+	LongOT(IO * io) {
+		this->io = io;
+		ot = new OTE<IO>(io);
+		mask = new uint8_t[chunk];
+	}
+
+	~LongOT() {
+		delete ot;
+		delete[] mask;
+	}
+
+	void send(const uint8_t * data0, const uint8_t * data1, const int64_t * lengths, int n) {
+		block * k0 = new block[n], * k1 = new block[n];
+		ot->send_rot(k0, k1, n);
+		for (int i = 0; i < n; ++i) {
+			send_masked(data0, k0[i], lengths[i]);
+			send_masked(data1, k1[i], lengths[i]);
+			data0 += lengths[i];
+			data1 += lengths[i];
+		}
+		delete[] k0;
+		delete[] k1;
+	}
+
+	void recv(uint8_t * data, const bool * b, const int64_t * lengths, int n) {
+		block * k = new block[n];
+		ot->recv_rot(k, b, n);
+		for (int i = 0; i < n; ++i) {
+			recv_masked(data, b[i] ? nullptr : &k[i], lengths[i]);
+			recv_masked(data, b[i] ? &k[i] : nullptr, lengths[i]);
+			data += lengths[i];
+		}
+		delete[] k;
+	}
+
+	// all messages are `length` bytes long
+	void send_fixed(const uint8_t * data0, const uint8_t * data1, int64_t length, int n) {
+		std::vector<int64_t> lengths(n, length);
+		send(data0, data1, lengths.data(), n);
+	}
+
+	void recv_fixed(uint8_t * data, const bool * b, int64_t length, int n) {
+		std::vector<int64_t> lengths(n, length);
+		recv(data, b, lengths.data(), n);
+	}
+
+	static void xor_bytes(uint8_t * out, const uint8_t * in, int length) {
+		int k = 0;
+		for (; k + 16 <= length; k += 16) {
+			block x = _mm_loadu_si128((const block *)(out+k));
+			block y = _mm_loadu_si128((const block *)(in+k));
+			_mm_storeu_si128((block *)(out+k), xorBlocks(x, y));
+		}
+		for (; k < length; ++k)
+			out[k] ^= in[k];
+	}
+
+	void send_masked(const uint8_t * data, const block & key, int64_t length) {
+		prg.reseed(&key);
+		for (int64_t j = 0; j < length; j += chunk) {
+			int len = min((int64_t)chunk, length - j);
+			prg.random_data(mask, len);
+			xor_bytes(mask, data+j, len);
+			io->send_data(mask, len);
+		}
+	}
+
+	// unmasks into data when key is set, otherwise drops the other message
+	void recv_masked(uint8_t * data, const block * key, int64_t length) {
+		if (key != nullptr)
+			prg.reseed(key);
+		for (int64_t j = 0; j < length; j += chunk) {
+			int len = min((int64_t)chunk, length - j);
+			if (key == nullptr) {
+				io->recv_data(mask, len);
+				continue;
+			}
+			io->recv_data(data+j, len);
+			prg.random_data(mask, len);
+			xor_bytes(data+j, mask, len);
+		}
+	}
+};
+/**@}*/
+}
+#endif// OT_LONG_OT_H__
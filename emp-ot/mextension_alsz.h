@@ -2,6 +2,8 @@
 #define OT_M_EXTENSION_ALSZ_H__
 #include "emp-ot/ot.h"
 #include "emp-ot/co.h"
+#include <thread>
+#include <vector>
 
 /** @addtogroup OT
     @{
@@ -12,26 +14,27 @@ class MOTExtension_ALSZ: public OT<MOTExtension_ALSZ<IO>> { public:
 	OTCO<IO> * base_ot;
 	PRG prg;
 	PRP pi;
-	int l, ssp;
+	int l, ssp, threads;
 
 	block *k0, *k1, * data_open = nullptr;
 	bool *s;
 
-	uint8_t * qT, *tT, *q = nullptr, **t, *block_s;
-	int u = 0;
+	// qT and tT hold one row per OT, w blocks each, zero padded past l bits
+	block *qT, *tT = nullptr, *block_s;
+	int u = 0, w;
 	bool setup = false;
 	bool committing = false;
 	char com[Hash::DIGEST_SIZE];
 	IO* io = nullptr;
-	MOTExtension_ALSZ(IO * io, bool committing = false, int ssp = 40): ssp(ssp){
+	MOTExtension_ALSZ(IO * io, bool committing = false, int ssp = 40, int threads = 1): ssp(ssp){
 		this->io = io;
-		this->l = 192;
-		u = 2;
+		this->threads = threads;
+		set_params(ssp);
 		this->base_ot = new OTCO<IO>(io);
 		this->s = new bool[l];
 		this->k0 = new block[l];
 		this->k1 = new block[l];
-		block_s = new uint8_t[l/8];
+		block_s = new block[w];
 		this->committing = committing;
 	}
 
@@ -44,6 +47,25 @@ class MOTExtension_ALSZ: public OT<MOTExtension_ALSZ<IO>> { public:
 		if(data_open != nullptr) {
 			delete[] data_open;
 		}
+		delete_array_null(tT);
+	}
+
+	/*
+	 * l base OTs and u check rounds for statistical security ssp, from the
+	 * ALSZ analysis for 128-bit computational security. Only tabulated ssp
+	 * values are accepted.
+	 */
+	void set_params(int ssp) {
+		const int params[][3] = {{40, 192, 2}};
+		l = 0;
+		for(auto & p : params)
+			if (p[0] == ssp) {
+				l = p[1];
+				u = p[2];
+			}
+		if (l == 0)
+			error("ALSZ: no parameters for this ssp");
+		w = (l+127)/128;
 	}
 
 	void xor_arr (uint8_t * a, uint8_t * b, uint8_t * c, int n) {
@@ -56,15 +78,50 @@ class MOTExtension_ALSZ: public OT<MOTExtension_ALSZ<IO>> { public:
 		}
 	}
 
-	block H(uint8_t* in, long id, int len) {
-		block res = zero_block();
-		for(int i = 0; i < len/16; ++i) {
-			res = xorBlocks(res, pi.H(_mm_loadl_epi64((block *)(in)), id));
-			in+=16;
+	/*
+	 * out[j] = XOR over k < w of PRP::H(row_j[k], w*(id+j)+k), for rows of w
+	 * blocks. The n*w blocks go through the fixed-key AES pipeline together;
+	 * `offset` (w blocks, or nullptr) is XORed into every row first.
+	 */
+	void H_rows(block * out, const block * rows, const block * offset, int64_t id, int n, block * scratch) {
+		for(int j = 0; j < n; ++j)
+			for(int k = 0; k < w; ++k) {
+				block x = rows[w*j+k];
+				if (offset != nullptr) x = xorBlocks(x, offset[k]);
+				scratch[w*j+k] = xorBlocks(x, makeBlock(0, w*(id+j)+k));
+			}
+		memcpy(scratch+w*n, scratch, w*n*sizeof(block));
+		pi.permute_block(scratch+w*n, w*n);
+		xorBlocks_arr(scratch, scratch, scratch+w*n, w*n);
+		for(int j = 0; j < n; ++j) {
+			out[j] = scratch[w*j];
+			for(int k = 1; k < w; ++k)
+				out[j] = xorBlocks(out[j], scratch[w*j+k]);
 		}
-		return res;	
 	}
 
+	/*
+	 * Transposes `rows` x `cols` bits, row r at in + r*stride bytes, into cols
+	 * rows of w blocks. rows must be a multiple of 16 and cols of 8; padding
+	 * bits of the output are left as they are.
+	 */
+	static void transpose(block * out, int w, const uint8_t * in, int rows, int64_t stride, int64_t cols) {
+		union { block x; uint8_t b[16]; } tmp;
+		uint8_t * o = (uint8_t *)out;
+		for(int rr = 0; rr < rows; rr += 16)
+			for(int64_t cc = 0; cc < cols; cc += 8) {
+				for(int i = 0; i < 16; ++i)
+					tmp.b[i] = in[(rr+i)*stride + cc/8];
+				for(int i = 7; i >= 0; --i) {
+					*(uint16_t *)(o + (cc+i)*16*w + rr/8) = _mm_movemask_epi8(tmp.x);
+					tmp.x = _mm_slli_epi64(tmp.x, 1);
+				}
+			}
+	}
+
+	// rows of OTs handled per hashing batch and network buffer
+	const static int post_bsize = 1024;
+
 	void bool_to_uint8(uint8_t * out, const bool*in, int len) {
 		for(int i = 0; i < len/8; ++i)
 			out[i] = 0;
@@ -72,17 +129,23 @@ class MOTExtension_ALSZ: public OT<MOTExtension_ALSZ<IO>> { public:
 			if(in[i])
 				out[i/8]|=(1<<(i%8));
 	}
+
+	// s as a row of w blocks
+	void set_block_s() {
+		memset(block_s, 0, w*sizeof(block));
+		bool_to_uint8((uint8_t *)block_s, s, l);
+	}
 	void setup_send(block * in_k0 = nullptr, bool * in_s = nullptr){
 		setup = true;
 		if(in_s != nullptr) {
 			memcpy(k0, in_k0, l*sizeof(block));
 			memcpy(s, in_s, l);
-			bool_to_uint8(block_s, s, l);
+			set_block_s();
 			return;
 		}
 		prg.random_bool(s, l);
 		base_ot->recv(k0, s, l);
-		bool_to_uint8(block_s, s, l);
+		set_block_s();
 	}
 	void setup_recv(block * in_k0 = nullptr, block * in_k1 =nullptr) {
 		setup = true;
@@ -97,199 +160,295 @@ class MOTExtension_ALSZ: public OT<MOTExtension_ALSZ<IO>> { public:
 		setup = true;
 	}
 
-	void ot_extension_send_pre(int length) {
-		assert(length%8==0);
-		if (length%128 !=0) length = (length/128 + 1)*128;
+	// OTs extended, checked and hashed per segment; bounds memory independently of length
+	int segment = 1<<20;
+	// bytes of each column generated and transposed together
+	const static int pre_chunk = 1<<14;
 
-		q = new uint8_t[length/8*l];
-		if(!setup)setup_send();
-		setup = false;
-		if(committing) {
-			Hash::hash_once(com, s, l);		
-			io->send_data(com, Hash::DIGEST_SIZE);
-		}
-		//get u, compute q
-		qT = new uint8_t[length/8*l];
-		uint8_t * q2 = new uint8_t[length/8*l];
-		uint8_t*tmp = new uint8_t[length/8];
+	static int64_t pad128(int64_t length) {
+		return (length+127)/128*128;
+	}
+
+	/*
+	 * Sender, OTs [off, off+length) of the call: columns are produced
+	 * pre_chunk bytes at a time from the base OT keys, at PRG offset off/8,
+	 * corrected by the receiver's u where s is set, and transposed straight
+	 * into qT.
+	 */
+	void ot_extension_send_pre(int64_t off, int length) {
+		length = pad128(length);
+		memset(qT, 0, (int64_t)length*w*sizeof(block));
+		uint8_t * q2 = new uint8_t[(int64_t)l*pre_chunk];
+		uint8_t * tmp = new uint8_t[pre_chunk];
 		PRG G;
-		for(int i = 0; i < l; ++i) {
-			io->recv_data(tmp, length/8);
-			G.reseed(&k0[i]);
-			G.random_data(q+(i*length/8), length/8);
-			if (s[i])
-				xor_arr(q2+(i*length/8), q+(i*length/8), tmp, length/8);
-			else
-				memcpy(q2+(i*length/8), q+(i*length/8), length/8);
+		for(int c = 0; c < length/8; c += pre_chunk) {
+			int m = min(pre_chunk, length/8-c);
+			for(int i = 0; i < l; ++i) {
+				uint8_t * col = q2+(int64_t)i*pre_chunk;
+				io->recv_data(tmp, m);
+				G.reseed(&k0[i]);
+				G.counter = (off/8+c)/16;
+				G.random_data(col, m);
+				if (s[i])
+					xor_arr(col, col, tmp, m);
+			}
+			transpose(qT+(int64_t)8*c*w, w, q2, l, pre_chunk, 8*m);
 		}
-		sse_trans(qT, q2, l, length);
 		delete[] tmp;
 		delete[] q2;
 	}
 
-	void ot_extension_recv_pre(block * data, const bool* r, int length) {
+	void ot_extension_recv_pre(const bool* r, int64_t off, int length) {
 		int old_length = length;
-		if (length%128 !=0) length = (length/128 + 1)*128;
-		if(!setup)setup_recv();
-		setup = false;
-		if(committing) {
-			io->recv_data(com, Hash::DIGEST_SIZE);
-		}
+		length = pad128(length);
+		memset(tT, 0, (int64_t)length*w*sizeof(block));
 		uint8_t *block_r = new uint8_t[length/8];
+		memset(block_r, 0, length/8);
 		bool_to_uint8(block_r, r, old_length);
-		// send u
-		t = new uint8_t*[2];
-		t[0] = new uint8_t[length/8*l];
-		t[1] = new uint8_t[length/8*l];
-		tT = new uint8_t[length/8*l];
-		uint8_t* tmp = new uint8_t[length/8];
+		uint8_t * t0 = new uint8_t[(int64_t)l*pre_chunk];
+		uint8_t * tmp = new uint8_t[pre_chunk];
 		PRG G;
-		for(int i = 0; i < l; ++i) {
-			G.reseed(&k0[i]);
-			G.random_data(&(t[0][i*length/8]), length/8);
-			G.reseed(&k1[i]);
-			G.random_data(t[1]+(i*length/8), length/8);
-			xor_arr(tmp, t[0]+(i*length/8), t[1]+(i*length/8), length/8);
-			xor_arr(tmp, block_r, tmp, length/8);
-			io->send_data(tmp, length/8);
+		for(int c = 0; c < length/8; c += pre_chunk) {
+			int m = min(pre_chunk, length/8-c);
+			for(int i = 0; i < l; ++i) {
+				uint8_t * col = t0+(int64_t)i*pre_chunk;
+				G.reseed(&k0[i]);
+				G.counter = (off/8+c)/16;
+				G.random_data(col, m);
+				G.reseed(&k1[i]);
+				G.counter = (off/8+c)/16;
+				G.random_data(tmp, m);
+				xor_arr(tmp, col, tmp, m);
+				xor_arr(tmp, block_r+c, tmp, m);
+				io->send_data(tmp, m);
+			}
+			transpose(tT+(int64_t)8*c*w, w, t0, l, pre_chunk, 8*m);
 		}
-
-		sse_trans(tT, t[0], l, length);
-
+		delete[] t0;
 		delete[] tmp;
 		delete[] block_r;
 	}
 
-	void ot_extension_send_post(const block* data0, const block* data1, int length) {
-		int old_length = length;
-		if (length%128 !=0) length = (length/128 + 1)*128;
-		//	uint8_t *pad0 = new uint8_t[l/8];
-		uint8_t *pad1 = new uint8_t[l/8];
-		block pad[2];
-		for(int i = 0; i < old_length; ++i) {
-			xor_arr(pad1, qT+i*l/8, block_s, l/8);
-			pad[0] = xorBlocks( H(qT+i*l/8, i, l/8), data0[i]);
-			pad[1] = xorBlocks( H(pad1, i, l/8), data1[i]);
-			io->send_data(pad, 2*sizeof(block));
+	// hashes of OTs use their index in the call, off + j, as tweak
+	void ot_extension_send_post(const block* data0, const block* data1, int64_t off, int length) {
+		block * scratch = new block[2*w*post_bsize];
+		block * pad = new block[2*post_bsize];
+		block h[post_bsize];
+		for(int i = 0; i < length; i += post_bsize) {
+			int n = min(post_bsize, length-i);
+			H_rows(h, qT+(int64_t)w*i, nullptr, off+i, n, scratch);
+			for(int j = 0; j < n; ++j)
+				pad[2*j] = xorBlocks(h[j], data0[i+j]);
+			H_rows(h, qT+(int64_t)w*i, block_s, off+i, n, scratch);
+			for(int j = 0; j < n; ++j)
+				pad[2*j+1] = xorBlocks(h[j], data1[i+j]);
+			io->send_data(pad, 2*n*sizeof(block));
 		}
-		delete[] pad1;
-		delete[] qT;
+		delete[] scratch;
+		delete[] pad;
 	}
 
-	void ot_extension_recv_check(int length) {
-		if (length%128 !=0) length = (length/128 + 1)*128;
-		block seed; PRG prg;int beta;
-		uint8_t * tmp = new uint8_t[length/8];
-		char dgst[Hash::DIGEST_SIZE];
+	// beta[i*l+j] is the column paired with column j in check round i
+	void derive_betas(int * beta, const block * seeds) {
+		uint32_t * v = new uint32_t[l];
 		for(int i = 0; i < u; ++i) {
-			io->recv_block(&seed, 1);
-			prg.reseed(&seed);
-			for(int j = 0; j < l; ++j) {
-				prg.random_data(&beta, 4);
-				beta = beta>0?beta:-1*beta;
-				beta %= l;
-				for(int k = 0; k < 2; ++k)
-					for(int l = 0; l < 2; ++l) {
-						xor_arr(tmp, t[k]+(j*length/8), t[l]+(beta*length/8), length/8);
-						Hash::hash_once(dgst, tmp, length/8);
-						io->send_data(dgst, Hash::DIGEST_SIZE);
-					}
-			}
+			PRG g(&seeds[i]);
+			g.random_data(v, l*sizeof(uint32_t));
+			for(int j = 0; j < l; ++j)
+				beta[i*l+j] = v[j] % l;
 		}
-		delete []tmp;
+		delete[] v;
 	}
 
-	void ot_extension_recv_post(block* data, const bool* r, int length) {
-		int old_length = length;
-		data_open = new block[length];
-		if (length%128 !=0) length = (length/128 + 1)*128;
-		block res[2];
-		for(int i = 0; i < old_length; ++i) {
-			io->recv_data(res, 2*sizeof(block));
-			block tmp = H(tT+i*l/8, i, l/8);
-			if(r[i]) {
-				data[i] = xorBlocks(res[1], tmp);
-				data_open[i] = res[0];
-			} else {
-				data[i] = xorBlocks(res[0], tmp);
-				data_open[i] = res[1];
-			}
-		}
-		if(!committing) {
-			delete[] tT;
-			tT=nullptr;
+	template<typename F>
+	void parallel(int nt, F f) {
+		std::vector<std::thread> workers;
+		for(int i = 1; i < nt; ++i)
+			workers.push_back(std::thread(f, i));
+		f(0);
+		for(auto & t : workers)
+			t.join();
+	}
+
+	// bytes of each column regenerated and hashed together by the check
+	const static int check_chunk = 1<<15;
+
+	/*
+	 * Digests of the check over `bytes` bytes of every column, starting at
+	 * byte `base` of the PRG streams. Columns are regenerated from the base OT
+	 * keys keys[0..sets) chunk by chunk and streamed into one hash state per
+	 * digest, so no full column is kept. For pair p = i*l+j, digest
+	 * p*sets*sets + a*sets + b hashes column j from key set a XOR column
+	 * beta[p] from key set b. Columns and pairs are spread over `threads`
+	 * threads.
+	 */
+	void check_digests(char * dgst, const block * const * keys, int sets, const int * beta, int64_t base, int64_t bytes) {
+		const int pairs = u*l, hashes = sets*sets;
+		const int nt = max(1, min(threads, l));
+		Hash * hash = new Hash[pairs*hashes];
+		uint8_t * col = new uint8_t[(int64_t)sets*l*check_chunk];
+		for(int64_t off = 0; off < bytes; off += check_chunk) {
+			int n = min((int64_t)check_chunk, bytes-off);
+			parallel(nt, [&](int id) {
+				PRG G(&keys[0][0]);
+				for(int c = id; c < sets*l; c += nt) {
+					G.reseed(&keys[c/l][c%l]);
+					G.counter = (base+off)/16;
+					G.random_data(col+(int64_t)c*check_chunk, n);
+				}
+			});
+			parallel(nt, [&](int id) {
+				uint8_t * tmp = new uint8_t[n];
+				for(int p = id*pairs/nt; p < (id+1)*pairs/nt; ++p)
+					for(int a = 0; a < sets; ++a)
+						for(int b = 0; b < sets; ++b) {
+							xor_arr(tmp, col+(int64_t)(a*l+p%l)*check_chunk,
+								col+(int64_t)(b*l+beta[p])*check_chunk, n);
+							hash[p*hashes+a*sets+b].put(tmp, n);
+						}
+				delete[] tmp;
+			});
 		}
+		for(int p = 0; p < pairs*hashes; ++p)
+			hash[p].digest(dgst+p*Hash::DIGEST_SIZE);
+		delete[] col;
+		delete[] hash;
+	}
+
+	void ot_extension_recv_check(int64_t off, int length) {
+		length = pad128(length);
+		block * seeds = new block[u];
+		int * beta = new int[u*l];
+		char * dgst = new char[u*l*4*Hash::DIGEST_SIZE];
+		const block * keys[2] = {k0, k1};
+		io->recv_block(seeds, u);
+		derive_betas(beta, seeds);
+		check_digests(dgst, keys, 2, beta, off/8, length/8);
+		io->send_data(dgst, u*l*4*Hash::DIGEST_SIZE);
+		delete[] seeds;
+		delete[] beta;
+		delete[] dgst;
 	}
-	bool ot_extension_send_check(int length) {
-		if (length%128 !=0) length = (length/128 + 1)*128;
-		bool cheat = false;
-		PRG prg, sprg; block seed;int beta;
-		char dgst[2][2][Hash::DIGEST_SIZE]; char dgstchk[Hash::DIGEST_SIZE];
-		uint8_t * tmp = new uint8_t[length/8];
-		for(int i = 0; i < u; ++i) {
-			prg.random_block(&seed, 1);
-			io->send_block(&seed, 1);
-			sprg.reseed(&seed);
-			for(int j = 0; j < l; ++j) {
-				sprg.random_data(&beta, 4);
-				beta = beta>0?beta:-1*beta;
-				beta %= l;
-				io->recv_data(dgst[0][0], Hash::DIGEST_SIZE);
-				io->recv_data(dgst[0][1], Hash::DIGEST_SIZE);
-				io->recv_data(dgst[1][0], Hash::DIGEST_SIZE);
-				io->recv_data(dgst[1][1], Hash::DIGEST_SIZE);
 
-				int ind1 = s[j]? 1:0;
-				int ind2 = s[beta]? 1:0;
-				xor_arr(tmp, q+(j*length/8), q+(beta*length/8), length/8);
-				Hash::hash_once(dgstchk, tmp, length/8);	
-				if (strncmp(dgstchk, dgst[ind1][ind2], Hash::DIGEST_SIZE)!=0)
-					cheat = true;
+	void ot_extension_recv_post(block* data, const bool* r, int64_t off, int length) {
+		block * scratch = new block[2*w*post_bsize];
+		block * res = new block[2*post_bsize];
+		block h[post_bsize];
+		for(int i = 0; i < length; i += post_bsize) {
+			int n = min(post_bsize, length-i);
+			io->recv_data(res, 2*n*sizeof(block));
+			H_rows(h, tT+(int64_t)w*i, nullptr, off+i, n, scratch);
+			for(int j = 0; j < n; ++j) {
+				data[i+j] = xorBlocks(res[2*j+r[i+j]], h[j]);
+				if(committing)
+					data_open[off+i+j] = res[2*j+1-r[i+j]];
 			}
 		}
-		delete[] tmp;
+		delete[] scratch;
+		delete[] res;
+	}
+
+	bool ot_extension_send_check(int64_t off, int length) {
+		length = pad128(length);
+		bool cheat = false;
+		block * seeds = new block[u];
+		int * beta = new int[u*l];
+		char * dgst = new char[u*l*4*Hash::DIGEST_SIZE];
+		char * dgstchk = new char[u*l*Hash::DIGEST_SIZE];
+		const block * keys[1] = {k0};
+		prg.random_block(seeds, u);
+		io->send_block(seeds, u);
+		io->flush();
+		derive_betas(beta, seeds);
+		check_digests(dgstchk, keys, 1, beta, off/8, length/8);
+		io->recv_data(dgst, u*l*4*Hash::DIGEST_SIZE);
+		for(int p = 0; p < u*l; ++p) {
+			int ind = 2*s[p%l] + s[beta[p]];
+			if (memcmp(dgstchk+p*Hash::DIGEST_SIZE, dgst+(4*p+ind)*Hash::DIGEST_SIZE, Hash::DIGEST_SIZE)!=0)
+				cheat = true;
+		}
+		delete[] seeds;
+		delete[] beta;
+		delete[] dgst;
+		delete[] dgstchk;
 		return cheat;
 	}
 
+	/*
+	 * Each call runs fresh base OTs, then extends, checks and hashes the OTs
+	 * one segment at a time, continuing the column PRG streams across
+	 * segments. Only qT or tT of one segment is kept, except that committing
+	 * mode keeps the receiver's tT for the whole call until open().
+	 */
 	void send_impl(const block* data0, const block* data1, int length) {
-		ot_extension_send_pre(length);
-		if (ot_extension_send_check(length)) {
-      std::cerr << "ot_extension_send_check failed" << std::endl;
-      exit(-1);
-    }
-		delete[] q; q = nullptr;
-		ot_extension_send_post(data0, data1, length);
+		if (segment % 128 != 0)
+			error("ALSZ segment must be a multiple of 128");
+		if(!setup)setup_send();
+		setup = false;
+		if(committing) {
+			Hash::hash_once(com, s, l);
+			io->send_data(com, Hash::DIGEST_SIZE);
+		}
+		qT = new block[pad128(min(segment, length))*w];
+		for(int64_t off = 0; off < length; off += segment) {
+			int n = min((int64_t)segment, length-off);
+			ot_extension_send_pre(off, n);
+			if (ot_extension_send_check(off, n))
+				error("ot_extension_send_check failed");
+			ot_extension_send_post(data0+off, data1+off, off, n);
+		}
+		delete[] qT;
 	}
 
 	void recv_impl(block* data, const bool* b, int length) {
-		ot_extension_recv_pre(data, b, length);
-		ot_extension_recv_check(length);
-		delete[] t[0];
-		delete[] t[1];
-		delete[] t;
-		ot_extension_recv_post(data, b, length);
+		if(!setup)setup_recv();
+		setup = false;
+		if(committing) {
+			io->recv_data(com, Hash::DIGEST_SIZE);
+			delete_array_null(data_open);
+			data_open = new block[length];
+		}
+		delete_array_null(tT);
+		tT = new block[(committing ? pad128(length) : pad128(min(segment, length)))*w];
+		for(int64_t off = 0; off < length; off += segment) {
+			int n = min((int64_t)segment, length-off);
+			block * seg = tT;
+			if (committing) tT = seg+off*w;
+			ot_extension_recv_pre(b+off, off, n);
+			ot_extension_recv_check(off, n);
+			ot_extension_recv_post(data+off, b+off, off, n);
+			tT = seg;
+		}
+		if(!committing) {
+			delete[] tT;
+			tT=nullptr;
+		}
 	}
 
 	void open() {		
 		io->send_data(s, l);		
 	}		
-	//return data[1-b]		
-	void open(block * data, const bool * r, int length) {		
-		io->recv_data(s, l);		
-		char com_recv[Hash::DIGEST_SIZE];		
-		Hash::hash_once(com_recv, s, l);		
-		if (strncmp(com_recv, com, Hash::DIGEST_SIZE)!= 0)		
-			assert(false);		
-		bool_to_uint8(block_s, s, l);		
-		for(int i = 0; i < length; ++i) {		
-			xor_arr(tT+i*l/8, tT+i*l/8, block_s, l/8);		
-			block tmp = H(tT+i*l/8, i, l/8);		
-			data[i] = xorBlocks(data_open[i], tmp);		
-		}		
+	//return data[1-b]
+	void open(block * data, const bool * r, int length) {
+		io->recv_data(s, l);
+		char com_recv[Hash::DIGEST_SIZE];
+		Hash::hash_once(com_recv, s, l);
+		if (memcmp(com_recv, com, Hash::DIGEST_SIZE)!= 0)
+			error("invalid commitment");
+		set_block_s();
+		block * scratch = new block[2*w*post_bsize];
+		block h[post_bsize];
+		for(int i = 0; i < length; i += post_bsize) {
+			int n = min(post_bsize, length-i);
+			H_rows(h, tT+(int64_t)w*i, block_s, i, n, scratch);
+			for(int j = 0; j < n; ++j)
+				data[i+j] = xorBlocks(data_open[i+j], h[j]);
+		}
+		delete[] scratch;
 		delete[] tT;
 		delete[] data_open;
-		tT=nullptr;	
-		data_open = nullptr;	
+		tT=nullptr;
+		data_open = nullptr;
 	}
 };
   /**@}*/
@@ -2,6 +2,9 @@
 #define OT_M_EXTENSION_KOS_H__
 #include "emp-ot/ot.h"
 #include "emp-ot/co.h"
+#include <memory>
+#include <thread>
+#include <vector>
 
 /** @addtogroup OT
   @{
@@ -10,7 +13,9 @@ namespace emp {
 template<typename IO>
 class MOTExtension_KOS: public OTExtension<IO, OTCO, emp::MOTExtension_KOS> { public:
 	block *open_data = nullptr;
-	bool committing = false;
+	// OTs of the last committing call, and the G0 block counter it started at
+	int64_t open_length = 0, open_counter = 0;
+	bool committing = false, opened = false;
 	char dgst[Hash::DIGEST_SIZE];
 	using OTExtension<IO, OTCO, emp::MOTExtension_KOS>::send_pre;
 	using OTExtension<IO, OTCO, emp::MOTExtension_KOS>::block_s;
@@ -22,15 +27,115 @@ class MOTExtension_KOS: public OTExtension<IO, OTCO, emp::MOTExtension_KOS> { pu
 	using OTExtension<IO, OTCO, emp::MOTExtension_KOS>::prg;
 	using OTExtension<IO, OTCO, emp::MOTExtension_KOS>::padded_length;
 	using OTExtension<IO, OTCO, emp::MOTExtension_KOS>::block_size;
+	using OTExtension<IO, OTCO, emp::MOTExtension_KOS>::k0;
+	using OTExtension<IO, OTCO, emp::MOTExtension_KOS>::G0;
+	using OTExtension<IO, OTCO, emp::MOTExtension_KOS>::ss_k;
+
+	using OTExtension<IO, OTCO, emp::MOTExtension_KOS>::ssp;
 
 	TCCRH tccrh;
-	MOTExtension_KOS(IO * io, bool committing = false, int ssp = 40) :
+	int threads, full_ssp;
+	// deferred checking, see set_deferred()
+	int64_t budget = 0, epoch_length = 0, pending_length = 0;
+	bool deferred_sender = false;
+	block epoch_seed, acc[3];
+	std::vector<std::pair<block*, std::function<void()>>> pending;
+
+	MOTExtension_KOS(IO * io, bool committing = false, int ssp = 40, int threads = 1) :
 		OTExtension<IO, OTCO, emp::MOTExtension_KOS>(io, ssp) {
 			this->committing = committing;
+			this->threads = threads;
+			this->full_ssp = ssp;
 		}
 
 	~MOTExtension_KOS() {
 		delete_array_null(open_data);
+		for(auto & p : pending)
+			delete[] p.first;
+	}
+
+	/*
+	 * Check kernel: res = sum over [lo, hi) of chi_j * v[j], as unreduced
+	 * 256-bit carry-less products, where chi_j is block j of PRG(seed). With
+	 * packed bits, x also gets the sum of chi_j over set bits, via masks.
+	 * Products are Karatsuba over `lanes` independent accumulators, and the
+	 * middle terms are recombined only once at the end. chi_j is taken at PRG
+	 * counter offset + j, so one seed can cover consecutive calls.
+	 */
+	template<bool with_x>
+	static void check_sum(block res[2], block * x, const block * v, const uint64_t * bits,
+			const block & seed, int64_t lo, int64_t hi, int64_t offset = 0) {
+		const int lanes = 4, bsize = 256;
+		block acc_lo[lanes], acc_mid[lanes], acc_hi[lanes], acc_x[lanes], chi[bsize];
+		for(int k = 0; k < lanes; ++k)
+			acc_lo[k] = acc_mid[k] = acc_hi[k] = acc_x[k] = zero_block();
+		PRG g(&seed);
+		g.counter = offset + lo;
+		for(int64_t i = lo; i < hi; i += bsize) {
+			int n = std::min((int64_t)bsize, hi - i);
+			g.random_block(chi, n);
+			for(int j = 0; j < n; j += lanes) {
+				for(int k = 0; k < lanes and j+k < n; ++k) {
+					block a = chi[j+k], b = v[i+j+k];
+					acc_lo[k] = xorBlocks(acc_lo[k], _mm_clmulepi64_si128(a, b, 0x00));
+					acc_hi[k] = xorBlocks(acc_hi[k], _mm_clmulepi64_si128(a, b, 0x11));
+					acc_mid[k] = xorBlocks(acc_mid[k], _mm_clmulepi64_si128(
+						xorBlocks(a, _mm_srli_si128(a, 8)), xorBlocks(b, _mm_srli_si128(b, 8)), 0x00));
+					if (with_x) {
+						int64_t p = i+j+k;
+						block mask = _mm_set1_epi64x(-(int64_t)((bits[p/64] >> (p%64)) & 1));
+						acc_x[k] = xorBlocks(acc_x[k], andBlocks(a, mask));
+					}
+				}
+			}
+		}
+		for(int k = 1; k < lanes; ++k) {
+			acc_lo[0] = xorBlocks(acc_lo[0], acc_lo[k]);
+			acc_mid[0] = xorBlocks(acc_mid[0], acc_mid[k]);
+			acc_hi[0] = xorBlocks(acc_hi[0], acc_hi[k]);
+			acc_x[0] = xorBlocks(acc_x[0], acc_x[k]);
+		}
+		block mid = xorBlocks(acc_mid[0], xorBlocks(acc_lo[0], acc_hi[0]));
+		res[0] = xorBlocks(acc_lo[0], _mm_slli_si128(mid, 8));
+		res[1] = xorBlocks(acc_hi[0], _mm_srli_si128(mid, 8));
+		if (with_x)
+			*x = acc_x[0];
+	}
+
+	// check_sum over [0, length), split in `threads` ranges and folded
+	template<bool with_x>
+	void check_sum_parallel(block res[2], block * x, const block * v, const uint64_t * bits,
+			const block & seed, int64_t length, int64_t offset = 0) {
+		int nt = std::max(1, std::min(threads, (int)(length / block_size)));
+		int64_t width = (length / nt + 63) / 64 * 64;
+		std::vector<block> part(3*nt);
+		std::vector<std::thread> workers;
+		for(int t = 1; t < nt; ++t)
+			workers.push_back(std::thread([&, t]() {
+				check_sum<with_x>(&part[3*t], &part[3*t+2], v, bits, seed, t*width, std::min(length, (t+1)*width), offset);
+			}));
+		check_sum<with_x>(&part[0], &part[2], v, bits, seed, 0, std::min(length, width), offset);
+		for(auto & w : workers)
+			w.join();
+		res[0] = res[1] = zero_block();
+		if (with_x) *x = zero_block();
+		for(int t = 0; t < nt; ++t) {
+			res[0] = xorBlocks(res[0], part[3*t]);
+			res[1] = xorBlocks(res[1], part[3*t+1]);
+			if (with_x) *x = xorBlocks(*x, part[3*t+2]);
+		}
+	}
+
+	// r followed by the random padding choices, 64 per word
+	uint64_t * pack_choices(const bool * r, int length) {
+		int extended_length = padded_length(length);
+		uint64_t * bits = new uint64_t[extended_length/64];
+		memset(bits, 0, extended_length/8);
+		for(int i = 0; i < length; ++i)
+			bits[i/64] |= (uint64_t)r[i] << (i%64);
+		for(int i = length; i < extended_length; ++i)
+			bits[i/64] |= (uint64_t)extended_r[i-length] << (i%64);
+		return bits;
 	}
 
 	bool send_check(int length) {
@@ -42,19 +147,7 @@ class MOTExtension_KOS: public OTExtension<IO, OTCO, emp::MOTExtension_KOS> { pu
 		int extended_length = padded_length(length);
 		block seed2, x, t[2], q[2], tmp1, tmp2;
 		io->recv_block(&seed2, 1);
-		block chi[block_size];
-		PRG prg2(&seed2);
-
-		q[0] = zero_block();
-		q[1] = zero_block();
-		for(int i = 0; i < extended_length/block_size; ++i) {
-			prg2.random_block(chi, block_size);
-			for(int j = 0; j < block_size; ++j) {
-				mul128(qT[i*block_size+j], chi[j], &tmp1, &tmp2);
-				q[0] = xorBlocks(q[0], tmp1);
-				q[1] = xorBlocks(q[1], tmp2);
-			}
-		}
+		check_sum_parallel<false>(q, nullptr, qT, nullptr, seed2, extended_length);
 		io->recv_block(&x, 1);
 		io->recv_block(t, 2);
 		mul128(x, block_s, &tmp1, &tmp2);
@@ -63,74 +156,194 @@ class MOTExtension_KOS: public OTExtension<IO, OTCO, emp::MOTExtension_KOS> { pu
 
 		return block_cmp(q, t, 2);	
 	}
+
 	void recv_check(const bool* r, int length) {
 		if (committing) {
 			io->recv_data(dgst, Hash::DIGEST_SIZE);
 		}
 
 		int extended_length = padded_length(length);
-		block chi[block_size];
-		block seed2, x = zero_block(), t[2], tmp1, tmp2;
+		block seed2, x, t[2];
 		prg.random_block(&seed2,1);
 		io->send_block(&seed2, 1);
-		PRG prg2(&seed2);
-		t[0] = t[1] = zero_block();
-
-		for(int i = 0; i < extended_length/block_size; ++i) {
-			prg2.random_block(chi, block_size);
-			for(int j = 0; j < block_size; ++j) {
-				mul128(chi[j], tT[i*block_size+j], &tmp1, &tmp2);
-				t[0] = xorBlocks(t[0], tmp1);
-				t[1] = xorBlocks(t[1], tmp2);
-				if (i*block_size+j < length and r[i*block_size+j])
-					x = xorBlocks(x, chi[j]);
-				else if (i*block_size+j >= length and extended_r[i*block_size+j-length]) 
-					x = xorBlocks(x, chi[j]);
-			}
-		}
+
+		uint64_t * bits = pack_choices(r, length);
+		check_sum_parallel<true>(t, &x, tT, bits, seed2, extended_length);
+		delete[] bits;
 		io->send_block(&x, 1);
 		io->send_block(t, 2);
 	}
+
+	/*
+	 * Deferred checking. With budget > 0, send_impl/recv_impl, send_cot/
+	 * recv_cot, send_rot/recv_rot and send_rot_bits/recv_rot_bits do not
+	 * check each call. Instead, both sides fold the chi-weighted sums of each
+	 * call into running accumulators. chi comes from one seed per epoch, sent
+	 * by the receiver with its first call, and only that first call pads ssp
+	 * random OTs to mask the combined x.
+	 *
+	 * Release policy: the sender sends nothing derived from its pads before
+	 * the check passes. The receiver's outputs, and the messages the sender
+	 * owes it, are written only inside verify(). The sender's own outputs
+	 * (ROT/COT pads) are filled in verify() as well. Until then, every buffer
+	 * passed to a deferred call must stay alive and unread. verify() runs once
+	 * `budget` OTs are pending, or when called explicitly; both parties must
+	 * call it at the same point.
+	 */
+	void set_deferred(int64_t budget) {
+		if (committing and budget > 0)
+			error("deferred checks do not support committing OT");
+		if (!pending.empty())
+			verify();
+		this->budget = budget;
+	}
+
+	// padded ssp OTs only for the first call of an epoch
+	void checked_send_pre(int length) {
+		ssp = (budget > 0 and epoch_length > 0) ? 0 : full_ssp;
+		send_pre(length);
+	}
+
+	void checked_recv_pre(const bool * r, int length) {
+		ssp = (budget > 0 and epoch_length > 0) ? 0 : full_ssp;
+		recv_pre(r, length);
+	}
+
+	void send_checked(int length, std::function<void()> post) {
+		if (budget == 0) {
+			if(!send_check(length))error("OT Extension check failed");
+			post();
+			return;
+		}
+		deferred_sender = true;
+		if (epoch_length == 0) {
+			io->recv_block(&epoch_seed, 1);
+			acc[0] = acc[1] = zero_block();
+		}
+		int extended_length = padded_length(length);
+		block q[2];
+		check_sum_parallel<false>(q, nullptr, qT, nullptr, epoch_seed, extended_length, epoch_length);
+		acc[0] = xorBlocks(acc[0], q[0]);
+		acc[1] = xorBlocks(acc[1], q[1]);
+		defer(extended_length, length, qT, post);
+	}
+
+	void recv_checked(const bool * r, int length, std::function<void()> post) {
+		if (budget == 0) {
+			recv_check(r, length);
+			post();
+			return;
+		}
+		deferred_sender = false;
+		if (epoch_length == 0) {
+			prg.random_block(&epoch_seed, 1);
+			io->send_block(&epoch_seed, 1);
+			acc[0] = acc[1] = acc[2] = zero_block();
+		}
+		int extended_length = padded_length(length);
+		block t[2], x;
+		uint64_t * bits = pack_choices(r, length);
+		check_sum_parallel<true>(t, &x, tT, bits, epoch_seed, extended_length, epoch_length);
+		delete[] bits;
+		acc[0] = xorBlocks(acc[0], t[0]);
+		acc[1] = xorBlocks(acc[1], t[1]);
+		acc[2] = xorBlocks(acc[2], x);
+		defer(extended_length, length, tT, post);
+	}
+
+	void defer(int extended_length, int length, block * rows, std::function<void()> post) {
+		epoch_length += extended_length;
+		pending_length += length;
+		pending.push_back(std::make_pair(rows, post));
+		if (pending_length >= budget)
+			verify();
+	}
+
+	// runs the combined check of the epoch, then releases all pending calls
+	void verify() {
+		if (pending.empty())
+			return;
+		if (deferred_sender) {
+			block x, t[2], q[2], tmp1, tmp2;
+			io->recv_block(&x, 1);
+			io->recv_block(t, 2);
+			mul128(x, block_s, &tmp1, &tmp2);
+			q[0] = xorBlocks(acc[0], tmp1);
+			q[1] = xorBlocks(acc[1], tmp2);
+			if (!block_cmp(q, t, 2))
+				error("OT Extension check failed");
+		} else {
+			io->send_block(&acc[2], 1);
+			io->send_block(acc, 2);
+		}
+		auto calls = std::move(pending);
+		pending.clear();
+		epoch_length = pending_length = 0;
+		for(auto & p : calls) {
+			if (deferred_sender) qT = p.first;
+			else tT = p.first;
+			p.second();
+		}
+		io->flush();
+	}
+
+	// OTs received and hashed per IO call on the receiver side
+	const static int recv_bsize = 1024;
+
+	static block choice_mask(bool b) {
+		return _mm_set1_epi64x(-(int64_t)b);
+	}
+
+	/*
+	 * pad[j] = H(tT[i+j], 2(i+j) + r[i+j]) for j < n. TCCRH is
+	 * H(x, t) = pi(pi(x) ^ t) ^ pi(x), so the first permutation is shared by
+	 * both tweaks, and the tweaks picked by r go in vector-wide after it.
+	 */
+	void recv_pads(block * pad, const bool * r, int i, int n) {
+		const int bsize = 2*AES_BATCH_SIZE;
+		block tmp[bsize];
+		for(int j = 0; j < n; j+=bsize) {
+			int m = min(bsize, n-j);
+			memcpy(tmp, tT+i+j, m*sizeof(block));
+			tccrh.permute_block(tmp, m);
+			for(int k = 0; k < m; ++k)
+				pad[j+k] = xorBlocks(tmp[k], makeBlock(0, 2*(uint64_t)(i+j+k) + r[i+j+k]));
+			tccrh.permute_block(pad+j, m);
+			xorBlocks_arr(pad+j, pad+j, tmp, m);
+		}
+	}
+
+	/*
+	 * In committing mode, open_data keeps only the other ciphertext of each OT
+	 * of the last call; open_range() rebuilds the rows it needs from G0.
+	 */
 	void got_recv_post(block* data, const bool* r, int length) {
 		const int bsize = AES_BATCH_SIZE;
 		block pad0[bsize];
 		block pad1[bsize];
 		if(committing) {
+			if (ss_k > 0)
+				error("committing OT needs IKNP columns");
 			delete_array_null(open_data);
 			open_data = new block[length];
-			for(int i = 0; i < length; i+=bsize) {
-				io->recv_data(pad0, sizeof(block)*min(bsize,length-i));
-				io->recv_data(pad1, sizeof(block)*min(bsize,length-i));
-				if (bsize <= length-i)tccrh.H<bsize>(tT+i, tT+i, i);
-				else tccrh.Hn(tT+i, tT+i, i, length -i);
-
-				for(int j = i; j < i+bsize and j < length; ++j) {
-					if (r[i]) {
-						data[j] = xorBlocks(tT[j], pad1[j-i]);
-						open_data[i] = pad0[j-i];
-					}
-					else {
-						data[j] = xorBlocks(tT[j], pad0[j-i]);
-						open_data[i] = pad1[j-i];;
-					}
-				}
-			}
-		} else {
-			for(int i = 0; i < length; i+=bsize) {
-				io->recv_data(pad0, sizeof(block)*min(bsize,length-i));
-				io->recv_data(pad1, sizeof(block)*min(bsize,length-i));
-				if (bsize <= length-i)tccrh.H<bsize>(tT+i, tT+i, i);
-				else tccrh.Hn(tT+i, tT+i, i, length -i);
-
-				for(int j = i; j < i+bsize and j < length; ++j) {
-					if (r[j])
-						data[j] = xorBlocks(tT[j], pad1[j-i]);
-					else
-						data[j] = xorBlocks(tT[j], pad0[j-i]);
-				}
-			}
-			delete[] tT;
+			open_length = length;
+			open_counter = G0[0].counter - padded_length(length)/128;
+			opened = false;
+		}
+		for(int i = 0; i < length; i+=bsize) {
+			int n = min(bsize, length-i);
+			io->recv_data(pad0, sizeof(block)*n);
+			io->recv_data(pad1, sizeof(block)*n);
+			if (committing)
+				for(int j = 0; j < n; ++j)
+					open_data[i+j] = r[i+j] ? pad0[j] : pad1[j];
+			if (bsize <= n) tccrh.H<bsize>(tT+i, tT+i, i);
+			else tccrh.Hn(tT+i, tT+i, i, n);
+
+			for(int j = 0; j < n; ++j)
+				data[i+j] = xorBlocks(tT[i+j], r[i+j] ? pad1[j] : pad0[j]);
 		}
+		delete[] tT;
 	}
 
 
@@ -177,14 +390,68 @@ class MOTExtension_KOS: public OTExtension<IO, OTCO, emp::MOTExtension_KOS> { pu
 		delete[] qT;
 	}
 
+	// arbitrary correlation: the receiver's 1-message of OT j is f(m0_j, j)
+	template<typename F>
+	void cot_send_post_ft(block* data0, F f, int length) {
+		const int bsize = AES_BATCH_SIZE;
+		block pad[2*bsize];
+		block tmp[bsize];
+		for(int i = 0; i < length; i+=bsize) {
+			int n = min(bsize, length-i);
+			for(int j = 0; j < n; ++j) {
+				pad[2*j] = qT[i+j];
+				pad[2*j+1] = xorBlocks(qT[i+j], block_s);
+			}
+			tccrh.H<2*bsize>(pad, pad, 2*i);
+			for(int j = 0; j < n; ++j) {
+				data0[i+j] = pad[2*j];
+				tmp[j] = xorBlocks(pad[2*j+1], f(pad[2*j], (uint64_t)(i+j)));
+			}
+			io->send_data(tmp, sizeof(block)*n);
+		}
+		delete[] qT;
+	}
+
+	// as cot_send_post, with OT j written to wires[ids[j]] (wires[j] if ids is nullptr)
+	void cot_send_post_labels(block* wires, const int* ids, block delta, int length) {
+		const int bsize = AES_BATCH_SIZE;
+		block pad[2*bsize];
+		block tmp[2*bsize];
+		for(int i = 0; i < length; i+=bsize) {
+			for(int j = i; j < i+bsize and j < length; ++j) {
+				pad[2*(j-i)] = qT[j];
+				pad[2*(j-i)+1] = xorBlocks(qT[j], block_s);
+			}
+			tccrh.H<2*bsize>(pad, pad, 2*i);
+			for(int j = i; j < i+bsize and j < length; ++j) {
+				wires[ids == nullptr ? j : ids[j]] = pad[2*(j-i)];
+				tmp[j-i] = xorBlocks(xorBlocks(pad[2*(j-i)+1], pad[2*(j-i)]), delta);
+			}
+			io->send_data(tmp, sizeof(block)*min(bsize,length-i));
+		}
+		delete[] qT;
+	}
+
+	void cot_recv_post_labels(block* wires, const int* ids, const bool* r, int length) {
+		block res[recv_bsize], pad[recv_bsize];
+		for(int i = 0; i < length; i+=recv_bsize) {
+			int n = min(recv_bsize, length-i);
+			io->recv_data(res, sizeof(block)*n);
+			recv_pads(pad, r, i, n);
+			for(int j = 0; j < n; ++j)
+				wires[ids == nullptr ? i+j : ids[i+j]] = xorBlocks(pad[j], andBlocks(res[j], choice_mask(r[i+j])));
+		}
+		delete[] tT;
+	}
+
 	void cot_recv_post(block* data, const bool* r, int length) {
-		block res;
-		for(int i = 0; i < length; ++i) {
-			io->recv_data(&res, sizeof(block));
-			if(r[i])
-				data[i] = xorBlocks(res, tccrh.H(tT[i], 2*i+1));
-			else 
-				data[i] = tccrh.H(tT[i], 2*i);
+		block res[recv_bsize];
+		for(int i = 0; i < length; i+=recv_bsize) {
+			int n = min(recv_bsize, length-i);
+			io->recv_data(res, sizeof(block)*n);
+			recv_pads(data+i, r, i, n);
+			for(int j = 0; j < n; ++j)
+				data[i+j] = xorBlocks(data[i+j], andBlocks(res[j], choice_mask(r[i+j])));
 		}
 		delete[] tT;
 	}
@@ -207,8 +474,8 @@ class MOTExtension_KOS: public OTExtension<IO, OTCO, emp::MOTExtension_KOS> { pu
 	}
 
 	void rot_recv_post(block* data, const bool* r, int length) {
-		for(int i = 0; i < length; ++i)
-			data[i] = tccrh.H(tT[i], 2*i+r[i]);
+		for(int i = 0; i < length; i+=recv_bsize)
+			recv_pads(data+i, r, i, min(recv_bsize, length-i));
 		delete[] tT;
 	}
 
@@ -216,28 +483,71 @@ class MOTExtension_KOS: public OTExtension<IO, OTCO, emp::MOTExtension_KOS> { pu
 
 
 
+	// random OT keeping only the LSB of each pad, packed 64 OTs per word
+	void rot_send_post_bits(uint64_t* data0, uint64_t* data1, int length) {
+		const int bsize = AES_BATCH_SIZE;
+		block pad[2*bsize];
+		for(int i = 0; i < length; i+=64) {
+			int n = min(64, length-i);
+			uint64_t w0 = 0, w1 = 0;
+			for(int j = 0; j < n; j+=bsize) {
+				for(int k = 0; k < bsize and j+k < n; ++k) {
+					pad[2*k] = qT[i+j+k];
+					pad[2*k+1] = xorBlocks(qT[i+j+k], block_s);
+				}
+				tccrh.H<2*bsize>(pad, pad, 2*(i+j));
+				for(int k = 0; k < bsize and j+k < n; ++k) {
+					w0 |= (uint64_t)(_mm_cvtsi128_si32(pad[2*k]) & 1) << (j+k);
+					w1 |= (uint64_t)(_mm_cvtsi128_si32(pad[2*k+1]) & 1) << (j+k);
+				}
+			}
+			data0[i/64] = w0;
+			data1[i/64] = w1;
+		}
+		delete[] qT;
+	}
+
+	void rot_recv_post_bits(uint64_t* data, const bool* r, int length) {
+		block pad[64];
+		for(int i = 0; i < length; i+=64) {
+			int n = min(64, length-i);
+			uint64_t w = 0;
+			recv_pads(pad, r, i, n);
+			for(int j = 0; j < n; ++j)
+				w |= (uint64_t)(_mm_cvtsi128_si32(pad[j]) & 1) << j;
+			data[i/64] = w;
+		}
+		delete[] tT;
+	}
+
 	void send_impl(const block* data0, const block* data1, int length) {
-		send_pre(length);
-		if(!send_check(length))	error("OT Extension check failed");
-		got_send_post(data0, data1, length);
+		checked_send_pre(length);
+		send_checked(length, [=]() { got_send_post(data0, data1, length); });
 	}
 
 	void recv_impl(block* data, const bool* b, int length) {
-		recv_pre(b, length);
-		recv_check(b, length);
-		got_recv_post(data, b, length);
+		checked_recv_pre(b, length);
+		recv_checked(b, length, [=]() { got_recv_post(data, b, length); });
 	}
 
 	void send_rot(block * data0, block * data1, int length) {
-		send_pre(length);
-		if(!send_check(length))error("OT Extension check failed");
-		rot_send_post(data0, data1, length);
+		checked_send_pre(length);
+		send_checked(length, [=]() { rot_send_post(data0, data1, length); });
 	}
 
 	void recv_rot(block* data, const bool* b, int length) {
-		recv_pre(b, length);
-		recv_check(b, length);
-		rot_recv_post(data, b, length);
+		checked_recv_pre(b, length);
+		recv_checked(b, length, [=]() { rot_recv_post(data, b, length); });
+	}
+
+	void send_rot_bits(uint64_t* data0, uint64_t* data1, int length) {
+		checked_send_pre(length);
+		send_checked(length, [=]() { rot_send_post_bits(data0, data1, length); });
+	}
+
+	void recv_rot_bits(uint64_t* data, const bool* b, int length) {
+		checked_recv_pre(b, length);
+		recv_checked(b, length, [=]() { rot_recv_post_bits(data, b, length); });
 	}
 
 	void cot_send_post_new(block* data0, const block* delta, int length) {
@@ -261,20 +571,83 @@ class MOTExtension_KOS: public OTExtension<IO, OTCO, emp::MOTExtension_KOS> { pu
 	}
 
 	void send_cot(block * data0, const block *delta, int length) {
-		send_pre(length);
-		if(!send_check(length))error("OT Extension check failed");
-		cot_send_post_new(data0, delta, length);
+		checked_send_pre(length);
+		send_checked(length, [=]() { cot_send_post_new(data0, delta, length); });
 	}
 	void send_cot(block * data0, block delta, int length) {
-		send_pre(length);
-		if(!send_check(length))error("OT Extension check failed");
-		cot_send_post(data0, delta, length);
+		checked_send_pre(length);
+		send_checked(length, [=]() { cot_send_post(data0, delta, length); });
+	}
+
+	/*
+	 * Arbitrary-correlation COTs, sent after the consistency check: the
+	 * receiver gets m0 or m1 = f(m0) through recv_cot, for one block of
+	 * sender traffic per OT.
+	 */
+	template<typename F>
+	void send_cot_ft(block * data0, F f, int length) {
+		checked_send_pre(length);
+		send_checked(length, [=]() { cot_send_post_ft(data0, f, length); });
+	}
+	void send_cot_f(block * data0, std::function<block(block, uint64_t)> f, int length) {
+		send_cot_ft(data0, f, length);
+	}
+	void send_cot_fs(block * data0, std::vector<std::function<block(block)>> fs, int length) {
+		auto shared = std::make_shared<std::vector<std::function<block(block)>>>(std::move(fs));
+		send_cot_ft(data0, [shared](block m0, uint64_t j) { return (*shared)[j](m0); }, length);
+	}
+	// m1 = m0 + deltas[j], as two 64-bit additions (first on the low half)
+	void send_cot_add_delta(block * data0, std::pair<uint64_t, uint64_t> * deltas, int length) {
+		send_cot_ft(data0, [deltas](block m0, uint64_t j) {
+			return makeBlock((uint64_t)m0[1] + deltas[j].second, (uint64_t)m0[0] + deltas[j].first);
+		}, length);
 	}
 
 	void recv_cot(block* data, const bool* b, int length) {
-		recv_pre(b, length);
-		recv_check(b, length);
-		cot_recv_post(data, b, length);
+		checked_recv_pre(b, length);
+		recv_checked(b, length, [=]() { cot_recv_post(data, b, length); });
+	}
+
+	/*
+	 * Garbling input labels: the 0-label of input i goes to wires[ids[i]]
+	 * (wires[i] if ids is nullptr), and the evaluator's choice for it is
+	 * values[ids[i]]. delta must have LSB 1 for point-and-permute. Labels are
+	 * produced `chunk` inputs per checked extension call, and ready(start, n)
+	 * is called once inputs start..start+n are in place. Labels are always
+	 * checked per chunk; pending deferred calls are verified first.
+	 */
+	void send_labels(block * wires, const int * ids, block delta, int length, int chunk = 1<<20,
+			std::function<void(int, int)> ready = nullptr) {
+		if (!getLSB(delta))
+			error("point-and-permute needs LSB(delta) = 1");
+		verify();
+		ssp = full_ssp;
+		for(int i = 0; i < length; i += chunk) {
+			int n = min(chunk, length-i);
+			send_pre(n);
+			if(!send_check(n))error("OT Extension check failed");
+			cot_send_post_labels(ids == nullptr ? wires+i : wires, ids == nullptr ? nullptr : ids+i, delta, n);
+			if (ready) ready(i, n);
+		}
+	}
+
+	void recv_labels(block * wires, const int * ids, const bool * values, int length, int chunk = 1<<20,
+			std::function<void(int, int)> ready = nullptr) {
+		bool * r = ids == nullptr ? nullptr : new bool[min(chunk, length)];
+		verify();
+		ssp = full_ssp;
+		for(int i = 0; i < length; i += chunk) {
+			int n = min(chunk, length-i);
+			if (ids != nullptr)
+				for(int j = 0; j < n; ++j)
+					r[j] = values[ids[i+j]];
+			const bool * b = ids == nullptr ? values+i : r;
+			recv_pre(b, n);
+			recv_check(b, n);
+			cot_recv_post_labels(ids == nullptr ? wires+i : wires, ids == nullptr ? nullptr : ids+i, b, n);
+			if (ready) ready(i, n);
+		}
+		delete_array_null(r);
 	}
 
 	void open() {
@@ -283,22 +656,61 @@ class MOTExtension_KOS: public OTExtension<IO, OTCO, emp::MOTExtension_KOS> { pu
 		io->send_block(&block_s, 1);		
 	}
 
-	void open(block * data, const bool * r, int length) {		
+	// receiver: takes s from the sender's open() and checks it against the commitment
+	void recv_open() {
 		if (!committing)
 			error("Committing not enabled");
-		io->recv_block(&block_s, 1);		
-		char com_recv[Hash::DIGEST_SIZE];		
-		Hash::hash_once(com_recv, &block_s, sizeof(block));		
-		if (strncmp(com_recv, dgst, 20)!= 0)
+		if (opened)
+			return;
+		io->recv_block(&block_s, 1);
+		char com_recv[Hash::DIGEST_SIZE];
+		Hash::hash_once(com_recv, &block_s, sizeof(block));
+		if (memcmp(com_recv, dgst, Hash::DIGEST_SIZE) != 0)
 			error("invalid commitment");
+		opened = true;
+	}
+
+	/*
+	 * receiver: data[j-lo] is the message not chosen in OT j of the last call,
+	 * for j in [lo, hi). Ranges can be opened incrementally, in any order.
+	 * Rows are rebuilt block_size OTs at a time by re-running the G0 column
+	 * streams from the call's counter and transposing.
+	 */
+	void open_range(block * data, int64_t lo, int64_t hi) {
+		if (lo < 0 or hi > open_length)
+			error("open range out of bounds");
+		recv_open();
+		const int bsize = AES_BATCH_SIZE;
+		block * t = new block[block_size];
+		block * rows = new block[block_size];
+		PRG G;
+		for(int64_t c = lo/128*128; c < hi; c += block_size) {
+			int m = (int)min((int64_t)block_size, (hi-c+127)/128*128);
+			for(int i = 0; i < 128; ++i) {
+				G.reseed(&k0[i]);
+				G.counter = open_counter + c/128;
+				G.random_data(t+(i*m/128), m/8);
+			}
+			sse_trans((uint8_t *)rows, (uint8_t *)t, 128, m);
+			int64_t start = max(lo, c), end = min(hi, c+m);
+			for(int64_t i = start; i < end; i += bsize) {
+				int n = min((int64_t)bsize, end-i);
+				block pad[bsize];
+				for(int j = 0; j < n; ++j)
+					pad[j] = xorBlocks(rows[i-c+j], block_s);
+				if (bsize <= n) tccrh.H<bsize>(pad, pad, i);
+				else tccrh.Hn(pad, pad, i, n);
+				for(int j = 0; j < n; ++j)
+					data[i-lo+j] = xorBlocks(open_data[i+j], pad[j]);
+			}
+		}
+		delete[] t;
+		delete[] rows;
+	}
 
-		for(int i = 0; i < length; ++i) {	
-			tT[i] = xorBlocks(tT[i], block_s);
-			if(r[i])
-				data[i] = xorBlocks(open_data[i], tccrh.H(tT[i], 2*i));
-			else	
-				data[i] = xorBlocks(open_data[i], tccrh.H(tT[i], 2*i+1));
-		}		
+	// the choice bits r are implied by the retained state and not needed
+	void open(block * data, const bool * r, int length) {
+		open_range(data, 0, length);
 	}
 };
 
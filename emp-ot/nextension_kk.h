@@ -0,0 +1,200 @@
+#ifndef OT_N_EXTENSION_KK_H__
+#define OT_N_EXTENSION_KK_H__
+#include "emp-ot/ot.h"
+#include "emp-ot/ot_extension.h"
+#include "emp-ot/np.h"
+/** @addtogroup OT
+  @{
+ */
+namespace emp {
+/*
+ * Semi-honest 1-out-of-N OT extension for 2 <= N <= 256 [KK13]. Each extended
+ * OT is a 256-bit IKNP row in which the receiver hides the Walsh-Hadamard
+ * codeword of its choice; since any two codewords differ in 128 positions,
+ * the N sender pads H(q_j ^ (c(x) & s)) stay independent. H is a
+ * Matyas-Meyer-Oseas chain over both row blocks started from the pad index,
+ * so every pad depends on all of s.
+ *
+ * Messages are laid out as data[j*N + x] for OT j and value x.
+ */
+template<typename IO>
+class NOTExtension_KK: public OTExtension<IO, OTNP, emp::NOTExtension_KK>{ public:
+	using OTExtension<IO, OTNP, emp::NOTExtension_KK>::send_pre_code;
+	using OTExtension<IO, OTNP, emp::NOTExtension_KK>::recv_pre_code;
+	using OTExtension<IO, OTNP, emp::NOTExtension_KK>::qT;
+	using OTExtension<IO, OTNP, emp::NOTExtension_KK>::tT;
+	using OTExtension<IO, OTNP, emp::NOTExtension_KK>::io;
+	using OTExtension<IO, OTNP, emp::NOTExtension_KK>::s;
+
+	const static int code_length = 256;
+	int N;
+	block *codewords = nullptr, *masks = nullptr;
+	PRP hash_prp;
+
+	NOTExtension_KK(IO * io, int N) : OTExtension<IO, OTNP, emp::NOTExtension_KK>(io, 0, code_length),
+		hash_prp(makeBlock(0, 7)) {
+		if (N < 2 or N > 256)
+			error("1-out-of-N OT supports 2 <= N <= 256");
+		this->N = N;
+		codewords = new block[2*N];
+		bool c[code_length];
+		for(int x = 0; x < N; ++x) {
+			for(int i = 0; i < code_length; ++i)
+				c[i] = __builtin_parity(x & i);
+			codewords[2*x] = bool_to128(c);
+			codewords[2*x+1] = bool_to128(c+128);
+		}
+	}
+
+	~NOTExtension_KK() {
+		delete[] codewords;
+		delete_array_null(masks);
+	}
+
+	// c(x) & s for every value x, computed once the base OTs are done
+	void compute_masks() {
+		if (masks != nullptr) return;
+		masks = new block[2*N];
+		block block_s[2] = {bool_to128(s), bool_to128(s+128)};
+		for(int x = 0; x < N; ++x) {
+			masks[2*x] = andBlocks(codewords[2*x], block_s[0]);
+			masks[2*x+1] = andBlocks(codewords[2*x+1], block_s[1]);
+		}
+	}
+
+	// number of OTs hashed together, so that each batch keeps AES busy
+	int hash_batch() {
+		return std::max(1, 4*AES_BATCH_SIZE/N);
+	}
+
+	// out[j] = H(id[j], rows[2j], rows[2j+1]); scratch holds n blocks
+	void hash_rows(block * out, const block * rows, const uint64_t * id, int n, block * scratch) {
+		for(int j = 0; j < n; ++j)
+			out[j] = makeBlock(0, id[j]);
+		for(int k = 0; k < 2; ++k) {
+			for(int j = 0; j < n; ++j)
+				scratch[j] = out[j] = xorBlocks(out[j], rows[2*j+k]);
+			hash_prp.permute_block(scratch, n);
+			xorBlocks_arr(out, out, scratch, n);
+		}
+	}
+
+	// pads of OTs i..i+n, all N values each; pad holds 2*N*n blocks, id N*n
+	void hash_send(block * out, block * pad, block * scratch, uint64_t * id, int i, int n) {
+		for(int j = 0; j < n; ++j) {
+			for(int x = 0; x < N; ++x) {
+				pad[2*(j*N+x)] = xorBlocks(qT[2*(i+j)], masks[2*x]);
+				pad[2*(j*N+x)+1] = xorBlocks(qT[2*(i+j)+1], masks[2*x+1]);
+				id[j*N+x] = (uint64_t)N*(i+j) + x;
+			}
+		}
+		hash_rows(out, pad, id, n*N, scratch);
+	}
+
+	// pads of the chosen values of OTs i..i+n; id and scratch hold n entries
+	void hash_recv(block * out, const uint8_t * r, uint64_t * id, int i, int n, block * scratch) {
+		for(int j = 0; j < n; ++j)
+			id[j] = (uint64_t)N*(i+j) + r[i+j];
+		hash_rows(out, tT+2*(uint64_t)i, id, n, scratch);
+	}
+
+	void got_send_post(const block* data, int length) {
+		const int bsize = hash_batch();
+		block * pad = new block[2*N*bsize];
+		block * scratch = new block[N*bsize];
+		block * res = new block[N*bsize];
+		uint64_t * id = new uint64_t[N*bsize];
+		for(int i = 0; i < length; i += bsize) {
+			int n = std::min(bsize, length-i);
+			hash_send(res, pad, scratch, id, i, n);
+			xorBlocks_arr(res, res, data+(uint64_t)i*N, n*N);
+			io->send_data(res, sizeof(block)*n*N);
+		}
+		delete[] pad;
+		delete[] scratch;
+		delete[] res;
+		delete[] id;
+		delete[] qT;
+	}
+
+	void got_recv_post(block* data, const uint8_t* r, int length) {
+		const int bsize = hash_batch();
+		block * res = new block[N*bsize];
+		block * scratch = new block[bsize];
+		uint64_t * id = new uint64_t[bsize];
+		for(int i = 0; i < length; i += bsize) {
+			int n = std::min(bsize, length-i);
+			io->recv_data(res, sizeof(block)*n*N);
+			hash_recv(data+i, r, id, i, n, scratch);
+			for(int j = 0; j < n; ++j)
+				data[i+j] = xorBlocks(data[i+j], res[j*N+r[i+j]]);
+		}
+		delete[] res;
+		delete[] scratch;
+		delete[] id;
+		delete[] tT;
+	}
+
+	void rot_send_post(block* data, int length) {
+		const int bsize = hash_batch();
+		block * pad = new block[2*N*bsize];
+		block * scratch = new block[N*bsize];
+		uint64_t * id = new uint64_t[N*bsize];
+		for(int i = 0; i < length; i += bsize)
+			hash_send(data+(uint64_t)i*N, pad, scratch, id, i, std::min(bsize, length-i));
+		delete[] pad;
+		delete[] scratch;
+		delete[] id;
+		delete[] qT;
+	}
+
+	void rot_recv_post(block* data, const uint8_t* r, int length) {
+		const int bsize = 8*AES_BATCH_SIZE;
+		block scratch[bsize];
+		uint64_t id[bsize];
+		for(int i = 0; i < length; i += bsize)
+			hash_recv(data+i, r, id, i, std::min(bsize, length-i), scratch);
+		delete[] tT;
+	}
+
+	void recv_pre(const uint8_t* r, int length) {
+		block * code = new block[2*length];
+		for(int i = 0; i < length; ++i) {
+			if (r[i] >= N)
+				error("1-out-of-N OT choice out of range");
+			code[2*i] = codewords[2*r[i]];
+			code[2*i+1] = codewords[2*r[i]+1];
+		}
+		recv_pre_code(code, length);
+		delete[] code;
+	}
+
+	void send_pre(int length) {
+		send_pre_code(length);
+		compute_masks();
+	}
+
+	// data holds length*N messages, data[i*N + x] is message x of OT i
+	void send(const block* data, int length) {
+		send_pre(length);
+		got_send_post(data, length);
+	}
+
+	void recv(block* data, const uint8_t* r, int length) {
+		recv_pre(r, length);
+		got_recv_post(data, r, length);
+	}
+
+	void send_rot(block* data, int length) {
+		send_pre(length);
+		rot_send_post(data, length);
+	}
+
+	void recv_rot(block* data, const uint8_t* r, int length) {
+		recv_pre(r, length);
+		rot_recv_post(data, r, length);
+	}
+};
+/**@}*/
+}
+#endif// OT_N_EXTENSION_KK_H__
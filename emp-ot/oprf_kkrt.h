@@ -0,0 +1,141 @@
+#ifndef OT_OPRF_KKRT_H__
+#define OT_OPRF_KKRT_H__
+#include "emp-ot/ot.h"
+#include "emp-ot/ot_extension.h"
+#include "emp-ot/np.h"
+#include <thread>
+#include <vector>
+/** @addtogroup OT
+  @{
+ */
+namespace emp {
+/*
+ * Batched oblivious PRF [KKRT16]: IKNP with a 512-bit pseudo-random code in
+ * place of the repetition code. For OPRF instance i the receiver hides C(x_i)
+ * in row i and learns F(i, x_i) = H(i, t_i); the sender, holding
+ * q_i = t_i ^ (C(x_i) & s), can evaluate F(i, y) = H(i, q_i ^ (C(y) & s)) on
+ * any y. C(x) is four fixed-key AES blocks of x, and H is a Matyas-Meyer-Oseas
+ * chain over the four row blocks started from the instance index.
+ *
+ * Inputs evaluated under one instance must be distinct; distinct inputs give
+ * codewords that differ in about half of their 512 bits.
+ */
+template<typename IO>
+class OPRF_KKRT: public OTExtension<IO, OTNP, emp::OPRF_KKRT>{ public:
+	using OTExtension<IO, OTNP, emp::OPRF_KKRT>::send_pre_code;
+	using OTExtension<IO, OTNP, emp::OPRF_KKRT>::recv_pre_code;
+	using OTExtension<IO, OTNP, emp::OPRF_KKRT>::qT;
+	using OTExtension<IO, OTNP, emp::OPRF_KKRT>::tT;
+	using OTExtension<IO, OTNP, emp::OPRF_KKRT>::s;
+
+	const static int code_length = 512;
+	const static int w = code_length/128;
+	// inputs encoded and hashed together
+	const static int batch = 64;
+	PRP code_prp, hash_prp;
+	block block_s[w];
+	int threads;
+	int64_t length = 0;
+
+	OPRF_KKRT(IO * io, int threads = 1) : OTExtension<IO, OTNP, emp::OPRF_KKRT>(io, 0, code_length),
+		code_prp(makeBlock(0, 4)), hash_prp(makeBlock(0, 5)) {
+		this->threads = threads;
+	}
+
+	~OPRF_KKRT() {
+		delete_array_null(qT);
+		delete_array_null(tT);
+	}
+
+	template<typename F>
+	void parallel(int64_t n, F f) {
+		if (threads <= 1 or n < 2*batch) {
+			f(0, n);
+			return;
+		}
+		std::vector<std::thread> workers;
+		int64_t width = (n + threads - 1) / threads;
+		width = (width + batch - 1) / batch * batch;
+		for (int64_t lo = 0; lo < n; lo += width)
+			workers.push_back(std::thread(f, lo, std::min(n, lo + width)));
+		for (auto & t : workers)
+			t.join();
+	}
+
+	// code[w*j+k] = AES(x_j ^ k)
+	void encode(block * code, const block * x, int n) {
+		for(int j = 0; j < n; ++j)
+			for(int k = 0; k < w; ++k)
+				code[w*j+k] = xorBlocks(x[j], makeBlock(k, 0));
+		code_prp.permute_block(code, w*n);
+	}
+
+	// out[j] = H(id[j], rows[w*j .. w*j+w))
+	void hash_rows(block * out, const block * rows, const int64_t * id, int n) {
+		block h[batch], x[batch];
+		for(int j = 0; j < n; ++j)
+			h[j] = makeBlock(0, id[j]);
+		for(int k = 0; k < w; ++k) {
+			for(int j = 0; j < n; ++j)
+				x[j] = h[j] = xorBlocks(h[j], rows[w*j+k]);
+			hash_prp.permute_block(x, n);
+			xorBlocks_arr(h, h, x, n);
+		}
+		memcpy(out, h, n*sizeof(block));
+	}
+
+	// sender: prepares `length` OPRF instances
+	void send(int64_t length) {
+		delete_array_null(qT);
+		qT = nullptr;
+		this->length = length;
+		send_pre_code(length);
+		for(int k = 0; k < w; ++k)
+			block_s[k] = bool_to128(s+128*k);
+	}
+
+	// sender: out[j] = F(id[j], y[j]), for any number of evaluations
+	void eval(block * out, const block * y, const int64_t * id, int64_t n) {
+		parallel(n, [&](int64_t lo, int64_t hi) {
+			block rows[w*batch];
+			for(int64_t i = lo; i < hi; i += batch) {
+				int m = std::min((int64_t)batch, hi - i);
+				encode(rows, y+i, m);
+				for(int j = 0; j < m; ++j) {
+					if (id[i+j] < 0 or id[i+j] >= length)
+						error("OPRF instance out of range");
+					const block * q = qT + w*id[i+j];
+					for(int k = 0; k < w; ++k)
+						rows[w*j+k] = xorBlocks(q[k], andBlocks(rows[w*j+k], block_s[k]));
+				}
+				hash_rows(out+i, rows, id+i, m);
+			}
+		});
+	}
+
+	// receiver: out[j] = F(j, x[j])
+	void recv(block * out, const block * x, int64_t length) {
+		this->length = length;
+		block * code = new block[w*length];
+		parallel(length, [&](int64_t lo, int64_t hi) {
+			for(int64_t i = lo; i < hi; i += batch)
+				encode(code+w*i, x+i, std::min((int64_t)batch, hi - i));
+		});
+		recv_pre_code(code, length);
+		delete[] code;
+		parallel(length, [&](int64_t lo, int64_t hi) {
+			int64_t id[batch];
+			for(int64_t i = lo; i < hi; i += batch) {
+				int m = std::min((int64_t)batch, hi - i);
+				for(int j = 0; j < m; ++j)
+					id[j] = i + j;
+				hash_rows(out+i, tT+w*i, id, m);
+			}
+		});
+		delete[] tT;
+		tT = nullptr;
+	}
+};
+/**@}*/
+}
+#endif// OT_OPRF_KKRT_H__
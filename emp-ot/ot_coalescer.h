@@ -0,0 +1,211 @@
+#ifndef OT_COALESCER_H__
+#define OT_COALESCER_H__
+#include <emp-tool/emp-tool.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <chrono>
+#include <deque>
+#include <unordered_map>
+/** @addtogroup OT
+  @{
+ */
+namespace emp {
+/*
+ * Front end that merges OT requests issued concurrently by many threads into
+ * one extension call. ALICE is the OT sender and decides batches: after the
+ * first request of a batch arrives it waits `window` for more (up to
+ * `max_batch` OTs), then announces the (tag, length) of every request in the
+ * batch. BOB waits until it holds requests with the same tags, runs the
+ * matching recv over their concatenation and scatters the results.
+ *
+ * Requests are matched across parties by a caller-chosen tag, which must be
+ * unique among outstanding requests and have the same length on both sides.
+ * The coalescer owns `io` until it is destroyed; BOB's destructor returns
+ * once ALICE's coalescer has been destroyed.
+ */
+template<typename IO, template<typename> class OTE>
+class OTCoalescer { public:
+	struct Request {
+		uint64_t tag;
+		int length;
+		const block * data0 = nullptr, * data1 = nullptr;
+		block * data = nullptr;
+		const bool * b = nullptr;
+		std::promise<void> done;
+	};
+
+	OTE<IO> * ot = nullptr;
+	IO * io = nullptr;
+	int party, max_batch;
+	std::chrono::microseconds window;
+	std::mutex mtx;
+	std::condition_variable cv;
+	std::deque<Request*> queue;
+	// OTs in queue, kept under mtx
+	int64_t queued_length = 0;
+	std::unordered_map<uint64_t, Request*> waiting;
+	bool stop = false;
+	std::thread worker;
+
+	OTCoalescer(IO * io, int party, int window_us = 100, int max_batch = 1<<20) {
+		this->io = io;
+		this->party = party;
+		this->max_batch = max_batch;
+		this->window = std::chrono::microseconds(window_us);
+		ot = new OTE<IO>(io);
+		if (party == ALICE)
+			worker = std::thread(&OTCoalescer::run_send, this);
+		else
+			worker = std::thread(&OTCoalescer::run_recv, this);
+	}
+
+	~OTCoalescer() {
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			stop = true;
+		}
+		cv.notify_all();
+		worker.join();
+		delete ot;
+	}
+
+	std::future<void> send(uint64_t tag, const block * data0, const block * data1, int length) {
+		Request * req = new Request;
+		req->tag = tag;
+		req->length = length;
+		req->data0 = data0;
+		req->data1 = data1;
+		std::future<void> res = req->done.get_future();
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			queue.push_back(req);
+			queued_length += length;
+		}
+		cv.notify_all();
+		return res;
+	}
+
+	std::future<void> recv(uint64_t tag, block * data, const bool * b, int length) {
+		Request * req = new Request;
+		req->tag = tag;
+		req->length = length;
+		req->data = data;
+		req->b = b;
+		std::future<void> res = req->done.get_future();
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			if (!waiting.insert(std::make_pair(tag, req)).second)
+				error("OTCoalescer: duplicate tag");
+		}
+		cv.notify_all();
+		return res;
+	}
+
+	void run_send() {
+		std::vector<Request*> batch;
+		std::vector<uint64_t> header;
+		std::vector<block> data0, data1;
+		while (true) {
+			std::unique_lock<std::mutex> lock(mtx);
+			cv.wait(lock, [this]{ return stop or !queue.empty(); });
+			if (queue.empty()) {
+				uint64_t end = 0;
+				io->send_data(&end, sizeof(uint64_t));
+				io->flush();
+				return;
+			}
+			auto deadline = std::chrono::steady_clock::now() + window;
+			cv.wait_until(lock, deadline, [this]{ return stop or queued_length >= max_batch; });
+
+			batch.clear();
+			int64_t total = 0;
+			while (!queue.empty() and (batch.empty() or total + queue.front()->length <= max_batch)) {
+				batch.push_back(queue.front());
+				total += queue.front()->length;
+				queued_length -= queue.front()->length;
+				queue.pop_front();
+			}
+			lock.unlock();
+
+			header.clear();
+			header.push_back(batch.size());
+			for (Request * req : batch) {
+				header.push_back(req->tag);
+				header.push_back(req->length);
+			}
+			data0.resize(total);
+			data1.resize(total);
+			int64_t offset = 0;
+			for (Request * req : batch) {
+				memcpy(data0.data() + offset, req->data0, req->length * sizeof(block));
+				memcpy(data1.data() + offset, req->data1, req->length * sizeof(block));
+				offset += req->length;
+			}
+			io->send_data(header.data(), header.size() * sizeof(uint64_t));
+			ot->send(data0.data(), data1.data(), total);
+			io->flush();
+			for (Request * req : batch) {
+				req->done.set_value();
+				delete req;
+			}
+		}
+	}
+
+	void run_recv() {
+		std::vector<Request*> batch;
+		std::vector<uint64_t> header;
+		std::vector<block> data;
+		bool * b = nullptr;
+		int64_t b_size = 0;
+		while (true) {
+			uint64_t size;
+			io->recv_data(&size, sizeof(uint64_t));
+			if (size == 0)
+				break;
+			header.resize(2 * size);
+			io->recv_data(header.data(), header.size() * sizeof(uint64_t));
+
+			batch.clear();
+			int64_t total = 0;
+			{
+				std::unique_lock<std::mutex> lock(mtx);
+				for (uint64_t i = 0; i < size; ++i) {
+					uint64_t tag = header[2*i];
+					cv.wait(lock, [this, tag]{ return waiting.count(tag) != 0; });
+					Request * req = waiting[tag];
+					waiting.erase(tag);
+					if ((uint64_t)req->length != header[2*i+1])
+						error("OTCoalescer: request length mismatch");
+					batch.push_back(req);
+					total += req->length;
+				}
+			}
+
+			if (total > b_size) {
+				delete_array_null(b);
+				b = new bool[total];
+				b_size = total;
+			}
+			data.resize(total);
+			int64_t offset = 0;
+			for (Request * req : batch) {
+				memcpy(b + offset, req->b, req->length);
+				offset += req->length;
+			}
+			ot->recv(data.data(), b, total);
+			offset = 0;
+			for (Request * req : batch) {
+				memcpy(req->data, data.data() + offset, req->length * sizeof(block));
+				offset += req->length;
+				req->done.set_value();
+				delete req;
+			}
+		}
+		delete_array_null(b);
+	}
+};
+/**@}*/
+}
+#endif// OT_COALESCER_H__
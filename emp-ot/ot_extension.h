@@ -9,7 +9,7 @@ template<typename IO, template<typename> class BaseOT, template<typename> class
 class OTExtension: public OT<OTExtension<IO, BaseOT, OTE>> { public:
 	BaseOT<IO> * base_ot;
 	PRG prg;
-	const int l = 128;
+	const int l;
 	const int block_size = 1024*16;
 
 	block *k0 = nullptr, *k1 = nullptr, 
@@ -18,7 +18,10 @@ class OTExtension: public OT<OTExtension<IO, BaseOT, OTE>> { public:
 	bool *s = nullptr, * extended_r = nullptr, setup = false;
 	IO *io = nullptr;
 	int ssp;
-	OTExtension(IO * io, int ssp = 0) {
+	int ss_k = 0;
+	PRG *ss_G = nullptr;
+	block *ss_u = nullptr;
+	OTExtension(IO * io, int ssp = 0, int l = 128) : l(l) {
 		this->io = io;
 		this->ssp = ssp;
 		base_ot = new BaseOT<IO>(io);
@@ -40,6 +43,8 @@ class OTExtension: public OT<OTExtension<IO, BaseOT, OTE>> { public:
 		delete[] G1;
 		delete[] tmp;
 		delete[] extended_r;
+		delete_array_null(ss_G);
+		delete_array_null(ss_u);
 	}
 
 	void setup_send(block * in_k0 = nullptr, bool * in_s = nullptr) {
@@ -55,6 +60,7 @@ class OTExtension: public OT<OTExtension<IO, BaseOT, OTE>> { public:
 		}
 		for(int i = 0; i < l; ++i)
 			G0[i].reseed(&k0[i]);
+		if (ss_k > 0) ss_setup_send();
 	}
 
 	void setup_recv(block * in_k0 = nullptr, block * in_k1 =nullptr) {
@@ -71,6 +77,127 @@ class OTExtension: public OT<OTExtension<IO, BaseOT, OTE>> { public:
 			G0[i].reseed(&k0[i]);
 			G1[i].reseed(&k1[i]);
 		}
+		if (ss_k > 0) ss_setup_recv();
+	}
+
+	/*
+	 * SoftSpoken [Roy22] replaces the 2-seed PRGs of IKNP by small-field VOLE:
+	 * columns are grouped in chunks of ss_k, and for each chunk the receiver
+	 * holds 2^ss_k seeds, the sender all but the one indexed by its s bits of
+	 * the chunk (a punctured GGM tree over the chunk's ss_k base OTs). The
+	 * receiver then sends one correction bit per OT per chunk, l/ss_k bits per
+	 * OT in total, at the cost of 2^ss_k PRG streams per chunk.
+	 */
+	int ss_chunks() {
+		return (l + ss_k - 1) / ss_k;
+	}
+
+	int ss_width(int c) {
+		return std::min(ss_k, l - c*ss_k);
+	}
+
+	void ss_alloc() {
+		ss_G = new PRG[ss_chunks() << ss_k];
+		ss_u = new block[block_size/128];
+	}
+
+	// level i of an in-place GGM tree into level i+1
+	void ss_expand_level(block * tree, int i) {
+		for(int p = (1<<i) - 1; p >= 0; --p) {
+			PRG g(&tree[p]);
+			g.random_block(tree+2*p, 2);
+		}
+	}
+
+	// level i of chunk c is masked with base OT off+kc-1-i, so leaf x = s bits
+	void ss_setup_recv() {
+		ss_alloc();
+		block * tree = new block[1<<ss_k];
+		block * msg = new block[2*l];
+		for(int c = 0; c < ss_chunks(); ++c) {
+			int kc = ss_width(c), off = c*ss_k;
+			prg.random_block(tree, 1);
+			for(int i = 0; i < kc; ++i) {
+				ss_expand_level(tree, i);
+				block sum[2] = {zero_block(), zero_block()};
+				for(int x = 0; x < (2<<i); ++x)
+					sum[x&1] = xorBlocks(sum[x&1], tree[x]);
+				int idx = off + kc - 1 - i;
+				msg[2*idx] = xorBlocks(sum[1], k0[idx]);
+				msg[2*idx+1] = xorBlocks(sum[0], k1[idx]);
+			}
+			for(int x = 0; x < (1<<kc); ++x)
+				ss_G[(c<<ss_k) + x].reseed(&tree[x]);
+		}
+		io->send_block(msg, 2*l);
+		io->flush();
+		delete[] tree;
+		delete[] msg;
+	}
+
+	void ss_setup_send() {
+		ss_alloc();
+		block * tree = new block[1<<ss_k];
+		block * msg = new block[2*l];
+		io->recv_block(msg, 2*l);
+		for(int c = 0; c < ss_chunks(); ++c) {
+			int kc = ss_width(c), off = c*ss_k, path = 0;
+			for(int i = 0; i < kc; ++i) {
+				if (i > 0) ss_expand_level(tree, i);
+				int idx = off + kc - 1 - i;
+				int sibling = 2*path + !s[idx];
+				path = 2*path + s[idx];
+				tree[sibling] = tree[path] = zero_block();
+				block sum = xorBlocks(msg[2*idx + s[idx]], k0[idx]);
+				for(int x = !s[idx]; x < (2<<i); x += 2)
+					sum = xorBlocks(sum, tree[x]);
+				tree[sibling] = sum;
+			}
+			for(int x = 0; x < (1<<kc); ++x)
+				if (x != path) ss_G[(c<<ss_k) + x].reseed(&tree[x]);
+		}
+		delete[] tree;
+		delete[] msg;
+	}
+
+	// column i of chunk c: t_i = sum of seeds x with bit i set; u = sum of all
+	void ss_recv_columns(block * t, const block * r) {
+		const int w = block_size/128;
+		for(int c = 0; c < ss_chunks(); ++c) {
+			int kc = ss_width(c), off = c*ss_k;
+			memset(t+off*w, 0, kc*w*sizeof(block));
+			memcpy(ss_u, r, w*sizeof(block));
+			for(int x = 0; x < (1<<kc); ++x) {
+				ss_G[(c<<ss_k) + x].random_data(tmp, block_size/8);
+				xorBlocks_arr(ss_u, ss_u, tmp, w);
+				for(int i = 0; i < kc; ++i)
+					if ((x>>i) & 1)
+						xorBlocks_arr(t+(off+i)*w, t+(off+i)*w, tmp, w);
+			}
+			io->send_data(ss_u, block_size/8);
+		}
+	}
+
+	// q_i = sum of seeds x != delta with bit i of x^delta set, corrected by s_i*u
+	void ss_send_columns(block * q) {
+		const int w = block_size/128;
+		for(int c = 0; c < ss_chunks(); ++c) {
+			int kc = ss_width(c), off = c*ss_k, delta = 0;
+			for(int i = 0; i < kc; ++i)
+				delta |= s[off+i] << i;
+			memset(q+off*w, 0, kc*w*sizeof(block));
+			for(int x = 0; x < (1<<kc); ++x) {
+				if (x == delta) continue;
+				ss_G[(c<<ss_k) + x].random_data(tmp, block_size/8);
+				for(int i = 0; i < kc; ++i)
+					if (((x^delta)>>i) & 1)
+						xorBlocks_arr(q+(off+i)*w, q+(off+i)*w, tmp, w);
+			}
+			io->recv_data(ss_u, block_size/8);
+			for(int i = 0; i < kc; ++i)
+				if (s[off+i])
+					xorBlocks_arr(q+(off+i)*w, q+(off+i)*w, ss_u, w);
+		}
 	}
 
 	int padded_length(int length){
@@ -84,7 +211,8 @@ class OTExtension: public OT<OTExtension<IO, BaseOT, OTE>> { public:
 		if(!setup) setup_send();
 
 		for (int j = 0; j < length/block_size; ++j) {
-			for(int i = 0; i < l; ++i) {
+			if (ss_k > 0) ss_send_columns(q);
+			else for(int i = 0; i < l; ++i) {
 				G0[i].random_data(q+(i*block_size/128), block_size/8);
 				io->recv_data(tmp, block_size/8);
 				if (s[i])
@@ -113,7 +241,8 @@ class OTExtension: public OT<OTExtension<IO, BaseOT, OTE>> { public:
 		}
 
 		for (int j = 0; j * block_size < length; ++j) {
-			for(int i = 0; i < l; ++i) {
+			if (ss_k > 0) ss_recv_columns(t, block_r+(j*block_size/128));
+			else for(int i = 0; i < l; ++i) {
 				G0[i].random_data(t+(i*block_size/128), block_size/8);
 				G1[i].random_data(tmp, block_size/8);
 				xorBlocks_arr(tmp, t+(i*block_size/128), tmp, block_size/128);
@@ -127,6 +256,62 @@ class OTExtension: public OT<OTExtension<IO, BaseOT, OTE>> { public:
 		delete[] r2;
 	}
 
+	/*
+	 * IKNP with an l-bit code in place of the repetition code (KK13, KKRT):
+	 * the receiver hides code[j] instead of r_j in row j, so the sender ends up
+	 * with qT row j = tT row j ^ (code[j] & s). Rows are l/128 blocks wide.
+	 */
+	void send_pre_code(int length) {
+		length = padded_length(length);
+		const int w = l/128;
+		block * q = new block[l*block_size/128];
+		qT = new block[(int64_t)length*w];
+		if(!setup) setup_send();
+
+		for (int j = 0; j < length/block_size; ++j) {
+			for(int i = 0; i < l; ++i) {
+				G0[i].random_data(q+(i*block_size/128), block_size/8);
+				io->recv_data(tmp, block_size/8);
+				if (s[i])
+					xorBlocks_arr(q+(i*block_size/128), q+(i*block_size/128), tmp, block_size/128);
+			}
+			sse_trans((uint8_t *)(qT+(int64_t)j*block_size*w), (uint8_t*)q, l, block_size);
+		}
+		delete[] q;
+	}
+
+	void recv_pre_code(const block* code, int length) {
+		int old_length = length;
+		length = padded_length(length);
+		const int w = l/128;
+		block * t = new block[l*block_size/128];
+		block * c = new block[l*block_size/128];
+		block * rows = new block[block_size*w];
+		tT = new block[(int64_t)length*w];
+
+		if(not setup) setup_recv();
+
+		for (int j = 0; j * block_size < length; ++j) {
+			int n = std::max(0, std::min(block_size, old_length - j*block_size));
+			if (n > 0)
+				memcpy(rows, code+(int64_t)j*block_size*w, n*w*sizeof(block));
+			memset(rows+n*w, 0, (block_size-n)*w*sizeof(block));
+			sse_trans((uint8_t *)c, (uint8_t*)rows, block_size, l);
+			for(int i = 0; i < l; ++i) {
+				G0[i].random_data(t+(i*block_size/128), block_size/8);
+				G1[i].random_data(tmp, block_size/8);
+				xorBlocks_arr(tmp, t+(i*block_size/128), tmp, block_size/128);
+				xorBlocks_arr(tmp, c+(i*block_size/128), tmp, block_size/128);
+				io->send_data(tmp, block_size/8);
+			}
+			sse_trans((uint8_t *)(tT+(int64_t)j*block_size*w), (uint8_t*)t, l, block_size);
+		}
+
+		delete[] t;
+		delete[] c;
+		delete[] rows;
+	}
+
 	void send_impl(const block* data0, const block* data1, int length) {
 		static_cast<OTE<IO>*>(this)->send_impl(data0, data1, length);
 	}
@@ -0,0 +1,183 @@
+#ifndef OT_PRIME_OLE_H__
+#define OT_PRIME_OLE_H__
+#include "emp-ot/shextension.h"
+#include <immintrin.h>
+/** @addtogroup OT
+  @{
+ */
+namespace emp {
+#ifdef __AVX2__
+// low 64-bit words of in[0..3]
+inline __m256i load_low_words(const block * in) {
+	__m256i v0 = _mm256_loadu_si256((const __m256i *)in);
+	__m256i v1 = _mm256_loadu_si256((const __m256i *)(in+2));
+	return _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(v0, v1), 0xD8);
+}
+#endif
+
+/*
+ * GF(2^61-1). Elements are kept fully reduced in [0, p).
+ */
+class Mersenne61 { public:
+	const static uint64_t p = (1ULL<<61) - 1;
+	const static int bits = 61;
+
+	static uint64_t reduce(uint64_t x) {
+		x = (x & p) + (x >> 61);
+		return x >= p ? x - p : x;
+	}
+
+	// x < 2^122
+	static uint64_t reduce(unsigned __int128 x) {
+		return reduce(((uint64_t)x & p) + (uint64_t)(x >> 61));
+	}
+
+	static uint64_t add(uint64_t a, uint64_t b) {
+		return reduce(a + b);
+	}
+
+	static uint64_t mul(uint64_t a, uint64_t b) {
+		return reduce((unsigned __int128)a * b);
+	}
+
+	// out[i] = low 64 bits of in[i] mod p
+	static void reduce_batch(uint64_t * out, const block * in, int64_t n) {
+		int64_t i = 0;
+#ifdef __AVX2__
+		const __m256i vp = _mm256_set1_epi64x(p);
+		const __m256i vp1 = _mm256_set1_epi64x(p - 1);
+		for (; i + 4 <= n; i += 4) {
+			__m256i x = load_low_words(in + i);
+			x = _mm256_add_epi64(_mm256_and_si256(x, vp), _mm256_srli_epi64(x, 61));
+			__m256i ge = _mm256_cmpgt_epi64(x, vp1);
+			x = _mm256_sub_epi64(x, _mm256_and_si256(ge, vp));
+			_mm256_storeu_si256((__m256i *)(out + i), x);
+		}
+#endif
+		for (; i < n; ++i)
+			out[i] = reduce((uint64_t)in[i][0]);
+	}
+};
+
+/*
+ * GF(2^64-59), the largest 64-bit prime. Products are reduced with
+ * 2^64 = 59 mod p.
+ */
+class Prime64 { public:
+	const static uint64_t p = 0xFFFFFFFFFFFFFFC5ULL;
+	const static uint64_t c = 59;
+	const static int bits = 64;
+
+	static uint64_t reduce(uint64_t x) {
+		return x >= p ? x - p : x;
+	}
+
+	static uint64_t reduce(unsigned __int128 x) {
+		for (int i = 0; i < 2; ++i)
+			x = (unsigned __int128)(uint64_t)(x >> 64) * c + (uint64_t)x;
+		uint64_t lo = (uint64_t)x + (uint64_t)(x >> 64) * c;
+		return reduce(lo);
+	}
+
+	static uint64_t add(uint64_t a, uint64_t b) {
+		uint64_t s = a + b;
+		return (s < a or s >= p) ? s - p : s;
+	}
+
+	static uint64_t mul(uint64_t a, uint64_t b) {
+		return reduce((unsigned __int128)a * b);
+	}
+
+	static void reduce_batch(uint64_t * out, const block * in, int64_t n) {
+		int64_t i = 0;
+#ifdef __AVX2__
+		const __m256i sign = _mm256_set1_epi64x(1ULL<<63);
+		const __m256i vp1 = _mm256_set1_epi64x((p - 1) ^ (1ULL<<63));
+		const __m256i vc = _mm256_set1_epi64x(c);
+		for (; i + 4 <= n; i += 4) {
+			__m256i x = load_low_words(in + i);
+			__m256i ge = _mm256_cmpgt_epi64(_mm256_xor_si256(x, sign), vp1);
+			x = _mm256_add_epi64(x, _mm256_and_si256(ge, vc));
+			_mm256_storeu_si256((__m256i *)(out + i), x);
+		}
+#endif
+		for (; i < n; ++i)
+			out[i] = reduce((uint64_t)in[i][0]);
+	}
+};
+
+/*
+ * Random-input OLE over a prime field F from Gilboa multiplication on
+ * SHOTExtension COTs. The sender inputs a[i] and gets b[i]; the receiver
+ * inputs x[i] and gets a[i]*x[i] + b[i] mod p. Each OLE costs F::bits COTs,
+ * one per bit of x[i], with correlation m1 = m0 + a*2^j mod p.
+ */
+template<typename IO, typename F>
+class PrimeOLE { public:
+	const static int bits = F::bits;
+	const static int batch = 1<<14;
+	SHOTExtension<IO> * ot = nullptr;
+	block * m = nullptr;
+	uint64_t * words = nullptr;
+	bool * choice = nullptr;
+
+	PrimeOLE(IO * io) {
+		ot = new SHOTExtension<IO>(io);
+		m = new block[batch*bits];
+		words = new uint64_t[batch*bits];
+	}
+
+	~PrimeOLE() {
+		delete ot;
+		delete[] m;
+		delete[] words;
+		delete_array_null(choice);
+	}
+
+	// sum of bits consecutive field elements
+	static uint64_t sum(const uint64_t * x) {
+		unsigned __int128 s = 0;
+		for (int j = 0; j < bits; ++j)
+			s += x[j];
+		return F::reduce(s);
+	}
+
+	void send(const uint64_t * a, uint64_t * b, int64_t n) {
+		for (int64_t i = 0; i < n; i += batch) {
+			int len = min((int64_t)batch, n - i);
+			for (int k = 0; k < len; ++k) {
+				uint64_t v = a[i+k];
+				for (int j = 0; j < bits; ++j) {
+					words[k*bits+j] = v;
+					v = F::add(v, v);
+				}
+			}
+			const uint64_t * pw = words;
+			auto f = [pw](block m0, uint64_t j) {
+				return makeBlock(0, F::add(F::reduce((uint64_t)m0[0]), pw[j]));
+			};
+			ot->send_cot_ft(m, f, len*bits);
+			F::reduce_batch(words, m, (int64_t)len*bits);
+			for (int k = 0; k < len; ++k)
+				b[i+k] = sum(words + k*bits);
+		}
+	}
+
+	void recv(const uint64_t * x, uint64_t * v, int64_t n) {
+		if (choice == nullptr)
+			choice = new bool[batch*bits];
+		for (int64_t i = 0; i < n; i += batch) {
+			int len = min((int64_t)batch, n - i);
+			for (int k = 0; k < len; ++k)
+				for (int j = 0; j < bits; ++j)
+					choice[k*bits+j] = (x[i+k] >> j) & 1;
+			ot->recv_cot(m, choice, len*bits);
+			F::reduce_batch(words, m, (int64_t)len*bits);
+			for (int k = 0; k < len; ++k)
+				v[i+k] = sum(words + k*bits);
+		}
+	}
+};
+/**@}*/
+}
+#endif// OT_PRIME_OLE_H__
@@ -0,0 +1,231 @@
+#ifndef OT_PSI_H__
+#define OT_PSI_H__
+#include "emp-ot/oprf_kkrt.h"
+#include <algorithm>
+/** @addtogroup OT
+  @{
+ */
+namespace emp {
+/*
+ * Semi-honest PSI from the KKRT OPRF. BOB (the OPRF receiver) places its
+ * items in 1.27n bins by cuckoo hashing with 3 hash functions and runs one
+ * OPRF per bin on (item, hash index), with random dummies in empty bins.
+ * ALICE evaluates the OPRF on every item at each of its 3 candidate bins and
+ * sends the values, truncated to 40 + log2(n_alice * n_bob) bits, as three
+ * shuffled lists, one per hash function. BOB looks them up in an open
+ * addressing table over its own values.
+ *
+ * Item hashing, OPRF encoding and evaluation run on `threads` threads.
+ */
+template<typename IO>
+class PSI_KKRT { public:
+	const static int hashes = 3;
+	const static int max_kicks = 500;
+	// sender values computed and sent together
+	const static int chunk = 1<<16;
+	IO * io = nullptr;
+	int party;
+	OPRF_KKRT<IO> * oprf = nullptr;
+	PRP bin_prp;
+	PRG prg;
+
+	PSI_KKRT(IO * io, int party, int threads = 1) : bin_prp(makeBlock(0, 6)) {
+		this->io = io;
+		this->party = party;
+		oprf = new OPRF_KKRT<IO>(io, threads);
+	}
+
+	~PSI_KKRT() {
+		delete oprf;
+	}
+
+	static int64_t num_bins(int64_t n) {
+		return std::max((int64_t)8, (n * 127 + 99) / 100);
+	}
+
+	static int value_bytes(int64_t n_alice, int64_t n_bob) {
+		int bits = 40;
+		for (int64_t x = 1; x < n_alice; x *= 2) ++bits;
+		for (int64_t x = 1; x < n_bob; x *= 2) ++bits;
+		return std::min(16, (bits + 7) / 8);
+	}
+
+	/*
+	 * key[i] = AES(x_i), and bin[3i+k] is taken from its k-th 32-bit word;
+	 * the OPRF input of x_i at its k-th bin is key[i] ^ k
+	 */
+	void hash_items(block * key, int64_t * bin, const block * x, int64_t n, int64_t bins) {
+		oprf->parallel(n, [&](int64_t lo, int64_t hi) {
+			memcpy(key+lo, x+lo, (hi-lo)*sizeof(block));
+			bin_prp.permute_block(key+lo, hi-lo);
+			for (int64_t i = lo; i < hi; ++i) {
+				const uint32_t * word = (const uint32_t *)(key+i);
+				for (int k = 0; k < hashes; ++k)
+					bin[hashes*i+k] = ((uint64_t)word[k] * bins) >> 32;
+			}
+		});
+	}
+
+	static block hash_input(const block & key, int k) {
+		return xorBlocks(key, makeBlock(k, 0));
+	}
+
+	// ALICE: `y` is its set, BOB holds n_bob items
+	void send(const block * y, int64_t n, int64_t n_bob) {
+		const int64_t bins = num_bins(n_bob);
+		const int bytes = value_bytes(n, n_bob);
+		block * key = new block[n];
+		int64_t * bin = new int64_t[hashes*n];
+		hash_items(key, bin, y, n, bins);
+		oprf->send(bins);
+
+		int64_t * perm = new int64_t[n];
+		block * in = new block[chunk], * out = new block[chunk];
+		int64_t * id = new int64_t[chunk];
+		uint8_t * buf = new uint8_t[(int64_t)chunk * bytes];
+		for (int k = 0; k < hashes; ++k) {
+			shuffle(perm, n);
+			for (int64_t i = 0; i < n; i += chunk) {
+				int m = std::min((int64_t)chunk, n - i);
+				for (int j = 0; j < m; ++j) {
+					in[j] = hash_input(key[perm[i+j]], k);
+					id[j] = bin[hashes*perm[i+j]+k];
+				}
+				oprf->eval(out, in, id, m);
+				for (int j = 0; j < m; ++j)
+					memcpy(buf + (int64_t)j * bytes, out+j, bytes);
+				io->send_data(buf, (int64_t)m * bytes);
+			}
+		}
+		io->flush();
+		delete[] key;
+		delete[] bin;
+		delete[] perm;
+		delete[] in;
+		delete[] out;
+		delete[] id;
+		delete[] buf;
+	}
+
+	/*
+	 * BOB: `x` is its set, ALICE holds n_alice items. Writes the indices of
+	 * the items of x in the intersection to `result`, in increasing order, and
+	 * returns their number.
+	 */
+	int64_t recv(int64_t * result, const block * x, int64_t n, int64_t n_alice) {
+		const int64_t bins = num_bins(n);
+		const int bytes = value_bytes(n_alice, n);
+		block * key = new block[n];
+		int64_t * bin = new int64_t[hashes*n];
+		hash_items(key, bin, x, n, bins);
+
+		int64_t * item = new int64_t[bins];
+		uint8_t * which = new uint8_t[bins];
+		cuckoo(item, which, bin, n, bins);
+		delete[] bin;
+
+		block * in = new block[bins], * value = new block[bins];
+		prg.random_block(in, bins);
+		for (int64_t b = 0; b < bins; ++b)
+			if (item[b] >= 0)
+				in[b] = hash_input(key[item[b]], which[b]);
+		delete[] key;
+		oprf->recv(value, in, bins);
+		delete[] in;
+
+		// open addressing over the first 8 value bytes, holding bin+1
+		int64_t size = 2;
+		while (size < 2*n) size *= 2;
+		uint64_t * tag = new uint64_t[size];
+		int64_t * slot = new int64_t[size];
+		memset(slot, 0, size*sizeof(int64_t));
+		for (int64_t b = 0; b < bins; ++b) {
+			if (item[b] < 0) continue;
+			uint64_t t = prefix(value+b, bytes);
+			int64_t p = t & (size-1);
+			while (slot[p] != 0) p = (p+1) & (size-1);
+			tag[p] = t;
+			slot[p] = b + 1;
+		}
+
+		bool * found = new bool[n];
+		memset(found, 0, n);
+		uint8_t * buf = new uint8_t[(int64_t)chunk * bytes];
+		for (int k = 0; k < hashes; ++k) {
+			for (int64_t i = 0; i < n_alice; i += chunk) {
+				int m = std::min((int64_t)chunk, n_alice - i);
+				io->recv_data(buf, (int64_t)m * bytes);
+				for (int j = 0; j < m; ++j) {
+					const uint8_t * v = buf + (int64_t)j * bytes;
+					uint64_t t = prefix(v, bytes);
+					for (int64_t p = t & (size-1); slot[p] != 0; p = (p+1) & (size-1)) {
+						int64_t b = slot[p] - 1;
+						if (tag[p] == t and which[b] == k and memcmp(v, value+b, bytes) == 0)
+							found[item[b]] = true;
+					}
+				}
+			}
+		}
+		int64_t cnt = 0;
+		for (int64_t i = 0; i < n; ++i)
+			if (found[i])
+				result[cnt++] = i;
+
+		delete[] item;
+		delete[] which;
+		delete[] value;
+		delete[] tag;
+		delete[] slot;
+		delete[] found;
+		delete[] buf;
+		return cnt;
+	}
+
+	// item[b] is the item in bin b (-1 if empty), placed by hash which[b]
+	void cuckoo(int64_t * item, uint8_t * which, const int64_t * bin, int64_t n, int64_t bins) {
+		for (int64_t b = 0; b < bins; ++b)
+			item[b] = -1;
+		uint8_t rnd[4096];
+		int used = (int)sizeof(rnd);
+		for (int64_t i = 0; i < n; ++i) {
+			int64_t cur = i;
+			int k = 0;
+			for (int kick = 0; ; ++kick) {
+				if (kick == max_kicks)
+					error("PSI: cuckoo hashing failed");
+				int64_t b = bin[hashes*cur+k];
+				std::swap(item[b], cur);
+				uint8_t old = which[b];
+				which[b] = k;
+				if (cur < 0)
+					break;
+				// the evicted item moves to one of its two other bins
+				if (used == (int)sizeof(rnd)) {
+					prg.random_data(rnd, sizeof(rnd));
+					used = 0;
+				}
+				k = (old + 1 + rnd[used++] % (hashes-1)) % hashes;
+			}
+		}
+	}
+
+	void shuffle(int64_t * perm, int64_t n) {
+		uint64_t r[1024];
+		for (int64_t i = 0; i < n; ++i)
+			perm[i] = i;
+		for (int64_t i = n-1; i > 0; --i) {
+			if (i % 1024 == 1023 or i == n-1)
+				prg.random_data(r, sizeof(r));
+			std::swap(perm[i], perm[r[i % 1024] % (i+1)]);
+		}
+	}
+
+	static uint64_t prefix(const void * v, int bytes) {
+		uint64_t t = 0;
+		memcpy(&t, v, std::min(bytes, 8));
+		return t;
+	}
+};
+/**@}*/
+}
+#endif// OT_PSI_H__
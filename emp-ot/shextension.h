@@ -3,13 +3,22 @@
 #include "emp-ot/ot.h"
 #include "emp-ot/ot_extension.h"
 #include "emp-ot/np.h"
+#include <type_traits>
 /** @addtogroup OT
   @{
  */
 namespace emp {
+/*
+ * softspoken = k in [2, 8] selects SoftSpoken extension with k-bit chunks:
+ * 128/k bits of u-matrix per OT instead of 128, for 2^k/k times the PRG
+ * work. 0 selects plain IKNP.
+ */
 template<typename IO>
 class SHOTExtension: public OTExtension<IO, OTNP, emp::SHOTExtension>{ public:
-	SHOTExtension(IO * io) : OTExtension<IO, OTNP, emp::SHOTExtension>(io){
+	SHOTExtension(IO * io, int softspoken = 0) : OTExtension<IO, OTNP, emp::SHOTExtension>(io){
+		if (softspoken != 0 and (softspoken < 2 or softspoken > 8))
+			error("SoftSpoken supports 2 <= k <= 8");
+		this->ss_k = softspoken;
 	}
 	CRH crh;
 	using OTExtension<IO, OTNP, emp::SHOTExtension>::send_pre;
@@ -51,6 +60,131 @@ class SHOTExtension: public OTExtension<IO, OTNP, emp::SHOTExtension>{ public:
 		delete[] tT;
 	}
 
+	// l-bit messages (1 <= l <= 64) are the low bits of each word; the masked
+	// pairs of 64 OTs are packed into 2*l words on the wire
+	void got_send_post_bits(const uint64_t* data0, const uint64_t* data1, int length, int l) {
+		const int bsize = AES_BATCH_SIZE/2;
+		const uint64_t mask = l == 64 ? ~0ULL : (1ULL<<l) - 1;
+		block pad[2*bsize];
+		uint64_t buf[2*64];
+		for(int i = 0; i < length; i+=64) {
+			int n = min(64, length-i);
+			memset(buf, 0, sizeof(buf));
+			for(int j = 0; j < n; j+=bsize) {
+				for(int k = 0; k < bsize and j+k < n; ++k) {
+					pad[2*k] = qT[i+j+k];
+					pad[2*k+1] = xorBlocks(qT[i+j+k], block_s);
+				}
+				crh.H<2*bsize>(pad, pad);
+				for(int k = 0; k < bsize and j+k < n; ++k) {
+					pack_bits(buf, 2*(j+k)*l, ((uint64_t)pad[2*k][0] ^ data0[i+j+k]) & mask, l);
+					pack_bits(buf, (2*(j+k)+1)*l, ((uint64_t)pad[2*k+1][0] ^ data1[i+j+k]) & mask, l);
+				}
+			}
+			io->send_data(buf, (2*l*n+7)/8);
+		}
+		delete[] qT;
+	}
+
+	void got_recv_post_bits(uint64_t* data, const bool* r, int length, int l) {
+		const int bsize = AES_BATCH_SIZE;
+		const uint64_t mask = l == 64 ? ~0ULL : (1ULL<<l) - 1;
+		uint64_t buf[2*64];
+		for(int i = 0; i < length; i+=64) {
+			int n = min(64, length-i);
+			io->recv_data(buf, (2*l*n+7)/8);
+			for(int j = 0; j < n; j+=bsize) {
+				if (bsize <= n-j) crh.H<bsize>(tT+i+j, tT+i+j);
+				else crh.Hn(tT+i+j, tT+i+j, n-j);
+			}
+			for(int j = 0; j < n; ++j)
+				data[i+j] = (unpack_bits(buf, (2*j+r[i+j])*l, l) ^ (uint64_t)tT[i+j][0]) & mask;
+		}
+		delete[] tT;
+	}
+
+	static void pack_bits(uint64_t* buf, int pos, uint64_t v, int l) {
+		int off = pos % 64;
+		buf[pos/64] |= v << off;
+		if (off + l > 64)
+			buf[pos/64+1] |= v >> (64 - off);
+	}
+
+	static uint64_t unpack_bits(const uint64_t* buf, int pos, int l) {
+		int off = pos % 64;
+		uint64_t v = buf[pos/64] >> off;
+		if (off + l > 64)
+			v |= buf[pos/64+1] << (64 - off);
+		return v;
+	}
+
+	// P is a batch correlation policy, see correlation.h
+	template<typename P>
+	void cot_send_post_p(block* data0, const P& policy, int length) {
+		const int bsize = AES_BATCH_SIZE;
+		block pad[2*bsize];
+		block tmp[bsize];
+		for(int i = 0; i < length; i+=bsize) {
+			int n = min(bsize, length-i);
+			for(int j = 0; j < n; ++j) {
+				pad[2*j] = qT[i+j];
+				pad[2*j+1] = xorBlocks(qT[i+j], block_s);
+			}
+			crh.H<2*bsize>(pad, pad);
+			for(int j = 0; j < n; ++j)
+				data0[i+j] = pad[2*j];
+			policy(tmp, data0+i, i, n);
+			for(int j = 0; j < n; ++j)
+				tmp[j] = xorBlocks(tmp[j], pad[2*j+1]);
+			io->send_data(tmp, sizeof(block)*n);
+		}
+		delete[] qT;
+	}
+
+	// COT over Z_2^k for k = 8*sizeof(W): the pads are truncated to W and the
+	// correction words are sent packed, sizeof(W) bytes per OT. The correlation
+	// is m1 = m0 + deltas[i], or m0 + delta when deltas is nullptr.
+	template<typename W>
+	void cot_send_post_trunc(W* data0, const W* deltas, W delta, int length) {
+		static_assert(std::is_unsigned<W>::value and sizeof(W) <= 8, "truncated COT needs an unsigned word of at most 64 bits");
+		const int bsize = AES_BATCH_SIZE;
+		block pad[2*bsize];
+		W tmp[bsize];
+		for(int i = 0; i < length; i+=bsize) {
+			int n = min(bsize, length-i);
+			for(int j = 0; j < n; ++j) {
+				pad[2*j] = qT[i+j];
+				pad[2*j+1] = xorBlocks(qT[i+j], block_s);
+			}
+			crh.H<2*bsize>(pad, pad);
+			for(int j = 0; j < n; ++j) {
+				data0[i+j] = (W)_mm_cvtsi128_si64(pad[2*j]);
+				W m1 = data0[i+j] + (deltas == nullptr ? delta : deltas[i+j]);
+				tmp[j] = m1 ^ (W)_mm_cvtsi128_si64(pad[2*j+1]);
+			}
+			io->send_data(tmp, sizeof(W)*n);
+		}
+		delete[] qT;
+	}
+
+	template<typename W>
+	void cot_recv_post_trunc(W* data, const bool* r, int length) {
+		const int bsize = AES_BATCH_SIZE;
+		block pad[bsize];
+		W res[bsize];
+		for(int i = 0; i < length; i+=bsize) {
+			int n = min(bsize, length-i);
+			io->recv_data(res, sizeof(W)*n);
+			if (bsize <= n) crh.H<bsize>(pad, tT+i);
+			else crh.Hn(pad, tT+i, n);
+			for(int j = 0; j < n; ++j) {
+				data[i+j] = (W)_mm_cvtsi128_si64(pad[j]);
+				if (r[i+j]) data[i+j] ^= res[j];
+			}
+		}
+		delete[] tT;
+	}
+
   template<typename F>
   void cot_send_post_ft(block* data0, F f, int length) {
     const int bsize = AES_BATCH_SIZE/2;
@@ -153,6 +287,39 @@ class SHOTExtension: public OTExtension<IO, OTNP, emp::SHOTExtension>{ public:
 		delete[] qT;
 	}
 
+	// as cot_send_post, with OT j written to wires[ids[j]] (wires[j] if ids is nullptr)
+	void cot_send_post_labels(block* wires, const int* ids, block delta, int length) {
+		const int bsize = AES_BATCH_SIZE/2;
+		block pad[2*bsize];
+		block tmp[2*bsize];
+		for(int i = 0; i < length; i+=bsize) {
+			for(int j = i; j < i+bsize and j < length; ++j) {
+				pad[2*(j-i)] = qT[j];
+				pad[2*(j-i)+1] = xorBlocks(qT[j], block_s);
+			}
+			crh.H<2*bsize>(pad, pad);
+			for(int j = i; j < i+bsize and j < length; ++j) {
+				wires[ids == nullptr ? j : ids[j]] = pad[2*(j-i)];
+				tmp[j-i] = xorBlocks(xorBlocks(pad[2*(j-i)+1], pad[2*(j-i)]), delta);
+			}
+			io->send_data(tmp, sizeof(block)*min(bsize,length-i));
+		}
+		delete[] qT;
+	}
+
+	void cot_recv_post_labels(block* wires, const int* ids, const bool* r, int length) {
+		const int bsize = AES_BATCH_SIZE;
+		block res[bsize], pad[bsize];
+		for(int i = 0; i < length; i+=bsize) {
+			io->recv_data(res, sizeof(block)*min(bsize,length-i));
+			if (bsize <= length-i) crh.H<bsize>(pad, tT+i);
+			else crh.Hn(pad, tT+i, length-i);
+			for(int j = 0; j < bsize and j < length-i; ++j)
+				wires[ids == nullptr ? i+j : ids[i+j]] = r[i+j] ? xorBlocks(res[j], pad[j]) : pad[j];
+		}
+		delete[] tT;
+	}
+
 	void cot_recv_post(block* data, const bool* r, int length) {
 		const int bsize = AES_BATCH_SIZE;
 		block res[bsize];
@@ -193,6 +360,47 @@ class SHOTExtension: public OTExtension<IO, OTNP, emp::SHOTExtension>{ public:
 		delete[] tT;
 	}
 
+	// random OT keeping only the LSB of each pad, packed 64 OTs per word
+	void rot_send_post_bits(uint64_t* data0, uint64_t* data1, int length) {
+		const int bsize = AES_BATCH_SIZE/2;
+		block pad[2*bsize];
+		for(int i = 0; i < length; i+=64) {
+			int n = min(64, length-i);
+			uint64_t w0 = 0, w1 = 0;
+			for(int j = 0; j < n; j+=bsize) {
+				for(int k = 0; k < bsize and j+k < n; ++k) {
+					pad[2*k] = qT[i+j+k];
+					pad[2*k+1] = xorBlocks(qT[i+j+k], block_s);
+				}
+				crh.H<2*bsize>(pad, pad);
+				for(int k = 0; k < bsize and j+k < n; ++k) {
+					w0 |= (uint64_t)(_mm_cvtsi128_si32(pad[2*k]) & 1) << (j+k);
+					w1 |= (uint64_t)(_mm_cvtsi128_si32(pad[2*k+1]) & 1) << (j+k);
+				}
+			}
+			data0[i/64] = w0;
+			data1[i/64] = w1;
+		}
+		delete[] qT;
+	}
+
+	void rot_recv_post_bits(uint64_t* data, const bool* r, int length) {
+		const int bsize = AES_BATCH_SIZE;
+		block pad[bsize];
+		for(int i = 0; i < length; i+=64) {
+			int n = min(64, length-i);
+			uint64_t w = 0;
+			for(int j = 0; j < n; j+=bsize) {
+				if (bsize <= n-j) crh.H<bsize>(pad, tT+i+j);
+				else crh.Hn(pad, tT+i+j, n-j);
+				for(int k = 0; k < bsize and j+k < n; ++k)
+					w |= (uint64_t)(_mm_cvtsi128_si32(pad[k]) & 1) << (j+k);
+			}
+			data[i/64] = w;
+		}
+		delete[] tT;
+	}
+
 	void send_impl(const block* data0, const block* data1, int length) {
 		send_pre(length);
 		got_send_post(data0, data1, length);
@@ -203,6 +411,20 @@ class SHOTExtension: public OTExtension<IO, OTNP, emp::SHOTExtension>{ public:
 		got_recv_post(data, b, length);
 	}
 
+	void send_bits(const uint64_t* data0, const uint64_t* data1, int length, int l) {
+		if (l < 1 or l > 64)
+			error("bit OT supports 1 <= l <= 64");
+		send_pre(length);
+		got_send_post_bits(data0, data1, length, l);
+	}
+
+	void recv_bits(uint64_t* data, const bool* b, int length, int l) {
+		if (l < 1 or l > 64)
+			error("bit OT supports 1 <= l <= 64");
+		recv_pre(b, length);
+		got_recv_post_bits(data, b, length, l);
+	}
+
   void send_cot(block * data0, block delta, int length) {
 		send_pre(length);
 		cot_send_post(data0, delta, length);
@@ -220,10 +442,64 @@ class SHOTExtension: public OTExtension<IO, OTNP, emp::SHOTExtension>{ public:
     send_pre(length);
     cot_send_post_ft(data0, f, length);
   }
+	template<typename P>
+	void send_cot_p(block * data0, const P& policy, int length) {
+		send_pre(length);
+		cot_send_post_p(data0, policy, length);
+	}
   void send_cot_add_delta(block * data0, std::pair<uint64_t, uint64_t> * deltas, int length) {
     send_pre(length);
     cot_send_post_add_delta(data0, deltas, length);
   }
+	template<typename W>
+	void send_cot_trunc(W * data0, const W * deltas, int length) {
+		send_pre(length);
+		cot_send_post_trunc(data0, deltas, (W)0, length);
+	}
+	template<typename W>
+	void send_cot_trunc(W * data0, W delta, int length) {
+		send_pre(length);
+		cot_send_post_trunc(data0, (const W*)nullptr, delta, length);
+	}
+	template<typename W>
+	void recv_cot_trunc(W * data, const bool* b, int length) {
+		recv_pre(b, length);
+		cot_recv_post_trunc(data, b, length);
+	}
+	/*
+	 * Garbling input labels: the 0-label of input i goes to wires[ids[i]]
+	 * (wires[i] if ids is nullptr), and the evaluator's choice for it is
+	 * values[ids[i]]. delta must have LSB 1 for point-and-permute. Labels are
+	 * produced `chunk` inputs per extension call, and ready(start, n) is called
+	 * once inputs start..start+n are in place.
+	 */
+	void send_labels(block * wires, const int * ids, block delta, int length, int chunk = 1<<20,
+			std::function<void(int, int)> ready = nullptr) {
+		if (!getLSB(delta))
+			error("point-and-permute needs LSB(delta) = 1");
+		for(int i = 0; i < length; i += chunk) {
+			int n = min(chunk, length-i);
+			send_pre(n);
+			cot_send_post_labels(ids == nullptr ? wires+i : wires, ids == nullptr ? nullptr : ids+i, delta, n);
+			if (ready) ready(i, n);
+		}
+	}
+
+	void recv_labels(block * wires, const int * ids, const bool * values, int length, int chunk = 1<<20,
+			std::function<void(int, int)> ready = nullptr) {
+		bool * r = ids == nullptr ? nullptr : new bool[min(chunk, length)];
+		for(int i = 0; i < length; i += chunk) {
+			int n = min(chunk, length-i);
+			if (ids != nullptr)
+				for(int j = 0; j < n; ++j)
+					r[j] = values[ids[i+j]];
+			const bool * b = ids == nullptr ? values+i : r;
+			recv_pre(b, n);
+			cot_recv_post_labels(ids == nullptr ? wires+i : wires, ids == nullptr ? nullptr : ids+i, b, n);
+			if (ready) ready(i, n);
+		}
+		delete_array_null(r);
+	}
 	void recv_cot(block* data, const bool* b, int length) {
 		recv_pre(b, length);
 		cot_recv_post(data, b, length);
@@ -236,6 +512,14 @@ class SHOTExtension: public OTExtension<IO, OTNP, emp::SHOTExtension>{ public:
 		recv_pre(b, length);
 		rot_recv_post(data, b, length);
 	}
+	void send_rot_bits(uint64_t* data0, uint64_t* data1, int length) {
+		send_pre(length);
+		rot_send_post_bits(data0, data1, length);
+	}
+	void recv_rot_bits(uint64_t* data, const bool* b, int length) {
+		recv_pre(b, length);
+		rot_recv_post_bits(data, b, length);
+	}
 };
 /**@}*/
 }
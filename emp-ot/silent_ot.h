@@ -0,0 +1,169 @@
+#ifndef OT_SILENT_OT_H__
+#define OT_SILENT_OT_H__
+#include <emp-tool/emp-tool.h>
+#include "emp-ot/ggm.h"
+/** @addtogroup OT
+  @{
+ */
+namespace emp {
+/*
+ * LPN-based silent COT in the style of Ferret (semi-honest variant). Each
+ * extension turns m = k + t*h base COTs into n = t*2^h COTs with a global
+ * delta held by ALICE, the sender:
+ *
+ *  - t single-point COTs, one per block of 2^h outputs (regular noise), from
+ *    GGMSPCOT. The punctured leaf of each tree is given by the choice bits of
+ *    its h base COTs, so the receiver sends nothing; the sender sends 2h+1
+ *    blocks.
+ *  - the first k base COTs are the LPN secret, added to every output row
+ *    through a fixed sparse matrix with d nonzeros per row.
+ *
+ * The last m outputs of each extension are kept as the base COTs of the next
+ * one, so only the first extension runs OTE (SHOTExtension or
+ * MOTExtension_KOS). Outputs use the layout of send_cot/recv_cot: the
+ * receiver gets data[i] = sender's data[i] ^ b[i]*delta.
+ */
+template<typename IO, template<typename> class OTE>
+class SilentCOT { public:
+	const static int d = 10;
+	IO * io = nullptr;
+	int party, k, t, h;
+	int64_t n, m, pos;
+	uint64_t iter = 0;
+	block delta;
+	PRG prg;
+	PRP prp;
+	TCCRH tccrh;
+	GGMSPCOT spcot;
+	block * out = nullptr, * base = nullptr;
+	bool * bits = nullptr, * base_bits = nullptr;
+
+	SilentCOT(IO * io, int party, int t = 1280, int h = 13, int k = 452000, int threads = 1) :
+		prp(makeBlock(0, 1)), spcot(h, threads) {
+		this->io = io;
+		this->party = party;
+		this->t = t;
+		this->h = h;
+		this->k = k;
+		n = (int64_t)t << h;
+		m = k + (int64_t)t * h;
+		if (m >= n)
+			error("SilentCOT: parameters produce no output");
+		out = new block[n];
+		base = new block[m];
+		if (party != ALICE) {
+			bits = new bool[n];
+			base_bits = new bool[m];
+		}
+		OTE<IO> * ot = new OTE<IO>(io);
+		if (party == ALICE) {
+			prg.random_block(&delta, 1);
+			ot->send_cot(base, delta, m);
+		} else {
+			prg.random_bool(base_bits, m);
+			ot->recv_cot(base, base_bits, m);
+		}
+		io->flush();
+		delete ot;
+		pos = n - m;
+	}
+
+	~SilentCOT() {
+		delete[] out;
+		delete[] base;
+		delete_array_null(bits);
+		delete_array_null(base_bits);
+	}
+
+	// sender: data[i] is the 0-message, data[i]^delta the 1-message
+	void send_cot(block * data, int64_t length) {
+		recv_cot(data, nullptr, length);
+	}
+
+	// receiver: data[i] is the b[i]-message, b is chosen at random
+	void recv_cot(block * data, bool * b, int64_t length) {
+		while (length > 0) {
+			if (pos == n - m)
+				extend();
+			int64_t len = min(length, n - m - pos);
+			memcpy(data, out + pos, len * sizeof(block));
+			if (b != nullptr)
+				memcpy(b, bits + pos, len);
+			pos += len;
+			data += len;
+			if (b != nullptr)
+				b += len;
+			length -= len;
+		}
+	}
+
+	void extend() {
+		if (party == ALICE)
+			spcot_send();
+		else
+			spcot_recv();
+		lpn();
+		memcpy(base, out + n - m, m * sizeof(block));
+		if (party != ALICE)
+			memcpy(base_bits, bits + n - m, m);
+		pos = 0;
+		++iter;
+	}
+
+	// the level-i base COT of tree j becomes a random OT through tccrh
+	void spcot_send() {
+		int64_t len = (int64_t)t * h;
+		block * m0 = new block[len], * m1 = new block[len];
+		for (int64_t i = 0; i < len; ++i) {
+			m0[i] = tccrh.H(base[k+i], iter * m + k + i);
+			m1[i] = tccrh.H(xorBlocks(base[k+i], delta), iter * m + k + i);
+		}
+		spcot.send(io, out, t, m0, m1, prg, &delta);
+		delete[] m0;
+		delete[] m1;
+	}
+
+	void spcot_recv() {
+		int64_t len = (int64_t)t * h;
+		block * mb = new block[len];
+		int * alpha = new int[t];
+		for (int64_t i = 0; i < len; ++i)
+			mb[i] = tccrh.H(base[k+i], iter * m + k + i);
+		spcot.recv(io, out, t, mb, base_bits + k, alpha, true);
+		memset(bits, 0, n);
+		for (int j = 0; j < t; ++j)
+			bits[((int64_t)j << h) + alpha[j]] = true;
+		delete[] mb;
+		delete[] alpha;
+	}
+
+	// out[i] ^= sum of d base COTs from the first k, at public random indices
+	void lpn() {
+		const int batch = 32;
+		block idx_blocks[3*batch];
+		for (int64_t i = 0; i < n; i += batch) {
+			int len = min((int64_t)batch, n - i);
+			for (int r = 0; r < len; ++r)
+				for (int j = 0; j < 3; ++j)
+					idx_blocks[3*r+j] = makeBlock(i + r, j);
+			prp.permute_block(idx_blocks, 3*len);
+			const uint32_t * idx = (const uint32_t *)idx_blocks;
+			for (int r = 0; r < len; ++r) {
+				block acc = out[i+r];
+				bool bit = false;
+				for (int q = 0; q < d; ++q) {
+					uint32_t c = ((uint64_t)idx[12*r+q] * k) >> 32;
+					acc = xorBlocks(acc, base[c]);
+					if (base_bits != nullptr)
+						bit ^= base_bits[c];
+				}
+				out[i+r] = acc;
+				if (bits != nullptr)
+					bits[i+r] ^= bit;
+			}
+		}
+	}
+};
+/**@}*/
+}
+#endif// OT_SILENT_OT_H__
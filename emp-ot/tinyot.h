@@ -0,0 +1,379 @@
+#ifndef OT_TINYOT_H__
+#define OT_TINYOT_H__
+#include "emp-ot/deltaot.h"
+#include <functional>
+/** @addtogroup OT
+  @{
+ */
+namespace emp {
+/*
+ * TinyOT preprocessing on two DeltaOT instances, one per direction. Each
+ * party has a global key Delta with LSB 1, as authenticated garbling expects.
+ * For each authenticated bit b of a party, it holds a MAC M[b] = K[b] ^ b*D.
+ * The key K[b] is held by the other party, and D is the other party's Delta.
+ *
+ * AND triples are built from leaky ANDs in two steps, as in [WRK17]:
+ *  - A half-AND on the cross terms gives shares of x*y. A consistency check
+ *    then compares x*(y*Delta) with z*Delta under each Delta. A cheating
+ *    party can learn x, but cannot pass the check with a wrong z.
+ *  - Leaky ANDs are combined in random buckets of B. The bucket keeps y of
+ *    its first triple, and the other triples are folded in on x.
+ *
+ * Values are bit-packed, 64 per word. Triples are produced `chunk` at a
+ * time, and each chunk is bucketed separately.
+ */
+class TinyOT { public:
+	NetIO * io = nullptr;
+	int party, ssp, chunk;
+	block * pretable = nullptr;
+	// own authenticates this party's bits; other holds Delta and the keys
+	DeltaOT * own = nullptr, * other = nullptr;
+	block Delta;
+	TCCRH tccrh;
+	PRG prg;
+	uint64_t tweak = 0;
+	// ANDs hashed and checked together
+	const static int batch = 1<<14;
+
+	TinyOT(NetIO * io, int party, int ssp = 40, int chunk = 1<<20) {
+		if (chunk % 64 != 0)
+			error("TinyOT: chunk must be a multiple of 64");
+		this->io = io;
+		this->party = party;
+		this->ssp = ssp;
+		this->chunk = chunk;
+		pretable = DeltaOT::preTable(ssp);
+		own = new DeltaOT(io, pretable, ssp);
+		other = new DeltaOT(io, pretable, ssp);
+		if (party == ALICE) {
+			own->setup_recv();
+			setup_delta();
+		} else {
+			setup_delta();
+			own->setup_recv();
+		}
+	}
+
+	~TinyOT() {
+		delete own;
+		delete other;
+		afree(pretable);
+	}
+
+	// random base OT choices, with one flipped if needed so that LSB(Delta) = 1
+	void setup_delta() {
+		bool * s = new bool[other->l];
+		block bs[2];
+		prg.random_bool(s, other->l);
+		other->bool_to256(s, bs);
+		if (!getLSB(other->bit_matrix_mul(bs))) {
+			bool e[256];
+			memset(e, 0, sizeof(e));
+			int i = 0;
+			for (; i < other->l; ++i) {
+				e[i] = true;
+				other->bool_to256(e, bs);
+				e[i] = false;
+				if (getLSB(other->bit_matrix_mul(bs)))
+					break;
+			}
+			if (i == other->l)
+				error("TinyOT: no Delta with LSB 1");
+			s[i] = !s[i];
+		}
+		other->setup_send(s);
+		Delta = other->Delta;
+		delete[] s;
+	}
+
+	static bool get_bit(const uint64_t * bits, int64_t i) {
+		return (bits[i/64] >> (i%64)) & 1;
+	}
+
+	static void set_bit(uint64_t * bits, int64_t i, bool b) {
+		bits[i/64] = (bits[i/64] & ~(1ULL << (i%64))) | ((uint64_t)b << (i%64));
+	}
+
+	// ALICE sends first, so large transfers cannot deadlock
+	void exchange(const void * mine, void * theirs, int bytes) {
+		if (party == ALICE) {
+			io->send_data(mine, bytes);
+			io->flush();
+			io->recv_data(theirs, bytes);
+		} else {
+			io->recv_data(theirs, bytes);
+			io->send_data(mine, bytes);
+			io->flush();
+		}
+	}
+
+	void random_abits(bool * bits, block * mac, block * key, int n) {
+		prg.random_bool(bits, n);
+		if (party == ALICE) {
+			own->recv(mac, bits, n);
+			other->send(key, n);
+		} else {
+			other->send(key, n);
+			own->recv(mac, bits, n);
+		}
+	}
+
+	// n random authenticated bits of this party, with their MACs, and keys
+	// for n random authenticated bits of the other party
+	void abits(uint64_t * bits, block * mac, block * key, int64_t n) {
+		bool * b = new bool[std::min((int64_t)chunk, n)];
+		for (int64_t i = 0; i < n; i += chunk) {
+			int m = std::min((int64_t)chunk, n - i);
+			random_abits(b, mac+i, key+i, m);
+			for (int j = 0; j < m; ++j)
+				set_bit(bits, i+j, b[j]);
+		}
+		delete[] b;
+	}
+
+	/*
+	 * L leaky ANDs: v holds x, y, z of this party, L bits each; mac and key
+	 * are laid out the same way
+	 */
+	void leaky_and(bool * v, block * mac, block * key, int L) {
+		bool * x = v, * y = v+L, * z = v+2*L;
+		random_abits(v, mac, key, 3*L);
+		const uint64_t g = tweak;
+		tweak += L;
+
+		// half-AND: x_i * y_j for i != j, from the MAC and the keys of x_i
+		block * hk = new block[batch], * hkd = new block[batch], * hm = new block[batch];
+		block * scratch = new block[batch];
+		bool * t = new bool[L], * t_o = new bool[L], * s = new bool[L];
+		for (int i = 0; i < L; i += batch) {
+			int n = std::min(batch, L - i);
+			for (int j = 0; j < n; ++j) {
+				hk[j] = key[i+j];
+				hkd[j] = xorBlocks(key[i+j], Delta);
+			}
+			tccrh.Hn(hk, hk, g+i, n, scratch);
+			tccrh.Hn(hkd, hkd, g+i, n, scratch);
+			tccrh.Hn(hm, mac+i, g+i, n, scratch);
+			for (int j = 0; j < n; ++j) {
+				t[i+j] = getLSB(hk[j]) ^ getLSB(hkd[j]) ^ y[i+j];
+				s[i+j] = getLSB(hk[j]) ^ getLSB(hm[j]);
+			}
+		}
+		exchange(t, t_o, L);
+		// z starts as a random authenticated r; publish d = r ^ z
+		for (int i = 0; i < L; ++i) {
+			bool w = (x[i] & y[i]) ^ s[i] ^ (x[i] & t_o[i]);
+			t[i] = z[i] ^ w;
+			z[i] = w;
+		}
+		exchange(t, t_o, L);
+		for (int i = 0; i < L; ++i)
+			if (t_o[i])
+				key[2*L+i] = xorBlocks(key[2*L+i], Delta);
+
+		delete[] hk;
+		delete[] hkd;
+		delete[] hm;
+		delete[] scratch;
+		delete[] t;
+		delete[] t_o;
+		delete[] s;
+		check(v, mac, key, L, g);
+	}
+
+	/*
+	 * For each party's Delta, both parties compute shares of x*(y*Delta) ^
+	 * z*Delta, which are equal iff z = x*y. The shares of y*Delta are
+	 * y*Delta ^ K[y'] for the Delta holder and M[y'] for the other party, and
+	 * likewise for z. The cross terms are half-ANDs on blocks, keyed by the
+	 * MACs and keys of x. The party without the Delta sends a digest of its
+	 * shares, and the Delta holder compares it with its own.
+	 */
+	void check(const bool * v, const block * mac, const block * key, int L, uint64_t g) {
+		const bool * x = v, * y = v+L, * z = v+2*L;
+		// c = 0: the check of our Delta, c = 1: the check of the other's
+		uint64_t tw[2];
+		tw[0] = g | ((uint64_t)(party == ALICE ? 1 : 2) << 60);
+		tw[1] = g | ((uint64_t)(party == ALICE ? 2 : 1) << 60);
+		block * hk = new block[batch], * hkd = new block[batch], * hm = new block[batch];
+		block * scratch = new block[batch];
+		block * u = new block[2*batch], * u_o = new block[2*batch], * share = new block[2*batch];
+		Hash digest[2];
+		for (int i = 0; i < L; i += batch) {
+			int n = std::min(batch, L - i);
+			for (int c = 0; c < 2; ++c) {
+				for (int j = 0; j < n; ++j) {
+					hk[j] = key[i+j];
+					hkd[j] = xorBlocks(key[i+j], Delta);
+				}
+				tccrh.Hn(hk, hk, tw[c]+i, n, scratch);
+				tccrh.Hn(hkd, hkd, tw[c]+i, n, scratch);
+				tccrh.Hn(hm, (block *)mac+i, tw[c]+i, n, scratch);
+				for (int j = 0; j < n; ++j) {
+					block phi, zd;
+					if (c == 0) {
+						phi = y[i+j] ? xorBlocks(key[L+i+j], Delta) : key[L+i+j];
+						zd = z[i+j] ? xorBlocks(key[2*L+i+j], Delta) : key[2*L+i+j];
+					} else {
+						phi = mac[L+i+j];
+						zd = mac[2*L+i+j];
+					}
+					u[2*j+c] = xorBlocks(xorBlocks(hk[j], hkd[j]), phi);
+					block sh = xorBlocks(xorBlocks(hm[j], hk[j]), zd);
+					share[2*j+c] = x[i+j] ? xorBlocks(sh, phi) : sh;
+				}
+			}
+			exchange(u, u_o, 2*n*sizeof(block));
+			for (int j = 0; j < n; ++j)
+				for (int c = 0; c < 2; ++c) {
+					block sh = x[i+j] ? xorBlocks(share[2*j+c], u_o[2*j+1-c]) : share[2*j+c];
+					digest[c].put_block(&sh);
+				}
+		}
+		char dig[2][Hash::DIGEST_SIZE], dig_o[Hash::DIGEST_SIZE];
+		digest[0].digest(dig[0]);
+		digest[1].digest(dig[1]);
+		exchange(dig[1], dig_o, Hash::DIGEST_SIZE);
+		delete[] hk;
+		delete[] hkd;
+		delete[] hm;
+		delete[] scratch;
+		delete[] u;
+		delete[] u_o;
+		delete[] share;
+		if (memcmp(dig[0], dig_o, Hash::DIGEST_SIZE) != 0)
+			error("TinyOT: leaky AND check failed");
+	}
+
+	// a bucket survives unless all of its B leaky ANDs leaked, about n^(1-B)
+	int bucket_size(int64_t n) {
+		int logn = 1;
+		while ((1LL << logn) < n) ++logn;
+		return 1 + (ssp + logn - 1) / logn;
+	}
+
+	// jointly random permutation of L leaky ANDs, from committed seeds
+	void bucket_perm(int * perm, int L) {
+		block seed, seed_o;
+		char com[Hash::DIGEST_SIZE], com_o[Hash::DIGEST_SIZE];
+		prg.random_block(&seed, 1);
+		Hash::hash_once(com, &seed, sizeof(block));
+		exchange(com, com_o, Hash::DIGEST_SIZE);
+		exchange(&seed, &seed_o, sizeof(block));
+		Hash::hash_once(com, &seed_o, sizeof(block));
+		if (memcmp(com, com_o, Hash::DIGEST_SIZE) != 0)
+			error("TinyOT: bucketing seed does not match its commitment");
+		seed = xorBlocks(seed, seed_o);
+		PRG shuffle(&seed);
+		uint32_t r[1024];
+		for (int i = 0; i < L; ++i)
+			perm[i] = i;
+		for (int i = L-1; i > 0; --i) {
+			if (i % 1024 == 1023 or i == L-1)
+				shuffle.random_data(r, sizeof(r));
+			std::swap(perm[i], perm[r[i % 1024] % (i+1)]);
+		}
+	}
+
+	/*
+	 * n triples from n*B leaky ANDs. In each bucket, d_j = y_1 ^ y_j is
+	 * opened with a MAC check, and then x = sum x_j, y = y_1,
+	 * z = sum z_j ^ d_j*x_j.
+	 */
+	void combine(uint64_t * x, uint64_t * y, uint64_t * z, block * mac, block * key, int64_t off,
+			int n, int B, const bool * v, const block * lm, const block * lk) {
+		const int L = n*B;
+		const bool * lx = v, * ly = v+L, * lz = v+2*L;
+		int * perm = new int[L];
+		bucket_perm(perm, L);
+
+		const int nd = n*(B-1);
+		bool * d = new bool[nd], * d_o = new bool[nd];
+		Hash mine, expect;
+		for (int b = 0; b < n; ++b) {
+			int p0 = perm[b*B];
+			for (int j = 1; j < B; ++j) {
+				int p = perm[b*B+j];
+				d[b*(B-1)+j-1] = ly[p0] ^ ly[p];
+				block m = xorBlocks(lm[L+p0], lm[L+p]);
+				mine.put_block(&m);
+			}
+		}
+		exchange(d, d_o, nd);
+		for (int b = 0; b < n; ++b) {
+			int p0 = perm[b*B];
+			for (int j = 1; j < B; ++j) {
+				int p = perm[b*B+j];
+				block k = xorBlocks(lk[L+p0], lk[L+p]);
+				if (d_o[b*(B-1)+j-1])
+					k = xorBlocks(k, Delta);
+				expect.put_block(&k);
+			}
+		}
+		char dig[Hash::DIGEST_SIZE], dig_e[Hash::DIGEST_SIZE], dig_o[Hash::DIGEST_SIZE];
+		mine.digest(dig);
+		expect.digest(dig_e);
+		exchange(dig, dig_o, Hash::DIGEST_SIZE);
+		if (memcmp(dig_e, dig_o, Hash::DIGEST_SIZE) != 0)
+			error("TinyOT: MAC check failed while combining");
+
+		for (int b = 0; b < n; ++b) {
+			int p0 = perm[b*B];
+			bool bx = lx[p0], bz = lz[p0];
+			block mx = lm[p0], mz = lm[2*L+p0], kx = lk[p0], kz = lk[2*L+p0];
+			for (int j = 1; j < B; ++j) {
+				int p = perm[b*B+j];
+				bool dj = d[b*(B-1)+j-1] ^ d_o[b*(B-1)+j-1];
+				bx ^= lx[p];
+				bz ^= lz[p] ^ (dj & lx[p]);
+				mx = xorBlocks(mx, lm[p]);
+				kx = xorBlocks(kx, lk[p]);
+				mz = xorBlocks(mz, lm[2*L+p]);
+				kz = xorBlocks(kz, lk[2*L+p]);
+				if (dj) {
+					mz = xorBlocks(mz, lm[p]);
+					kz = xorBlocks(kz, lk[p]);
+				}
+			}
+			int64_t o = off + b;
+			set_bit(x, o, bx);
+			set_bit(y, o, ly[p0]);
+			set_bit(z, o, bz);
+			mac[3*o] = mx;
+			mac[3*o+1] = lm[L+p0];
+			mac[3*o+2] = mz;
+			key[3*o] = kx;
+			key[3*o+1] = lk[L+p0];
+			key[3*o+2] = kz;
+		}
+		delete[] perm;
+		delete[] d;
+		delete[] d_o;
+	}
+
+	/*
+	 * n authenticated AND triples: this party's shares go to the bit arrays
+	 * x, y, z; mac[3i..3i+2] and key[3i..3i+2] belong to x_i, y_i, z_i.
+	 * ready(start, m) is called once triples start..start+m are in place.
+	 */
+	void generate(uint64_t * x, uint64_t * y, uint64_t * z, block * mac, block * key, int64_t n,
+			std::function<void(int64_t, int64_t)> ready = nullptr) {
+		const int first = std::min((int64_t)chunk, n), last = n - (n-1)/chunk*chunk;
+		const int max_L = std::max(first*bucket_size(first), last*bucket_size(last));
+		bool * v = new bool[3*max_L];
+		block * lm = new block[3*max_L], * lk = new block[3*max_L];
+		for (int64_t i = 0; i < n; i += chunk) {
+			int m = std::min((int64_t)chunk, n - i);
+			int B = bucket_size(m);
+			leaky_and(v, lm, lk, m*B);
+			combine(x, y, z, mac, key, i, m, B, v, lm, lk);
+			if (ready) ready(i, m);
+		}
+		delete[] v;
+		delete[] lm;
+		delete[] lk;
+	}
+};
+/**@}*/
+}
+#endif// OT_TINYOT_H__
@@ -0,0 +1,51 @@
+#include "test/test.h"
+#include <iostream>
+using namespace std;
+
+template<typename T>
+double test_arith_triple(NetIO ** ios, int threads, int party, int64_t n) {
+	T * a = new T[n], * b = new T[n], * c = new T[n];
+	T * a1 = new T[n], * b1 = new T[n], * c1 = new T[n];
+	for (int i = 0; i < threads; ++i)
+		ios[i]->sync();
+	auto start = clock_start();
+	ArithTriple<NetIO, T> * gen = new ArithTriple<NetIO, T>(ios, threads, party);
+	gen->generate(a, b, c, n);
+	long long t = time_from(start);
+	if (party == ALICE) {
+		ios[0]->send_data(a, n*sizeof(T));
+		ios[0]->send_data(b, n*sizeof(T));
+		ios[0]->send_data(c, n*sizeof(T));
+		ios[0]->flush();
+	} else {
+		ios[0]->recv_data(a1, n*sizeof(T));
+		ios[0]->recv_data(b1, n*sizeof(T));
+		ios[0]->recv_data(c1, n*sizeof(T));
+		for (int64_t i = 0; i < n; ++i)
+			if ((T)((a[i]+a1[i])*(b[i]+b1[i])) != (T)(c[i]+c1[i]))
+				error("arithmetic triple failed!");
+	}
+	delete gen;
+	delete[] a;
+	delete[] b;
+	delete[] c;
+	delete[] a1;
+	delete[] b1;
+	delete[] c1;
+	return t;
+}
+
+int main(int argc, char** argv) {
+	int port, party, threads = 2;
+	int64_t n = 1<<18;
+	parse_party_and_port(argv, 2, &party, &port);
+	NetIO * ios[threads];
+	for (int i = 0; i < threads; ++i)
+		ios[i] = new NetIO(party==ALICE ? nullptr:"127.0.0.1", port+i);
+	cout <<"Z_2^32 triples\t"<<double(n)/test_arith_triple<uint32_t>(ios, 1, party, n)*1e6<<" triples/s"<<endl;
+	cout <<"Z_2^64 triples\t"<<double(n)/test_arith_triple<uint64_t>(ios, 1, party, n)*1e6<<" triples/s"<<endl;
+	cout <<"Z_2^128 triples\t"<<double(n)/test_arith_triple<unsigned __int128>(ios, 1, party, n)*1e6<<" triples/s"<<endl;
+	cout <<"Z_2^64 triples ("<<threads<<" threads)\t"<<double(n)/test_arith_triple<uint64_t>(ios, threads, party, n)*1e6<<" triples/s"<<endl;
+	for (int i = 0; i < threads; ++i)
+		delete ios[i];
+}
@@ -0,0 +1,50 @@
+#include "test/test.h"
+#include <iostream>
+using namespace std;
+
+template<typename IO, template<typename> class T>
+double test_bit_triple(IO * io, int party, int64_t n) {
+	int64_t words = (n + 63) / 64;
+	uint64_t * a = new uint64_t[words], * b = new uint64_t[words], * c = new uint64_t[words];
+	uint64_t * a1 = new uint64_t[words], * b1 = new uint64_t[words], * c1 = new uint64_t[words];
+	io->sync();
+	auto start = clock_start();
+	BitTripleGen<IO, T> * gen = new BitTripleGen<IO, T>(io, party);
+	gen->generate(a, b, c, n);
+	io->flush();
+	long long t = time_from(start);
+	if (party == ALICE) {
+		io->send_data(a, words*sizeof(uint64_t));
+		io->send_data(b, words*sizeof(uint64_t));
+		io->send_data(c, words*sizeof(uint64_t));
+		io->flush();
+	} else {
+		io->recv_data(a1, words*sizeof(uint64_t));
+		io->recv_data(b1, words*sizeof(uint64_t));
+		io->recv_data(c1, words*sizeof(uint64_t));
+		uint64_t last = n % 64 == 0 ? ~0ULL : (1ULL << (n % 64)) - 1;
+		for (int64_t i = 0; i < words; ++i) {
+			uint64_t mask = i == words - 1 ? last : ~0ULL;
+			if ((((a[i]^a1[i]) & (b[i]^b1[i])) ^ c[i] ^ c1[i]) & mask)
+				error("Boolean triple failed!");
+		}
+	}
+	delete gen;
+	delete[] a;
+	delete[] b;
+	delete[] c;
+	delete[] a1;
+	delete[] b1;
+	delete[] c1;
+	return t;
+}
+
+int main(int argc, char** argv) {
+	int port, party;
+	int64_t n = (1<<23) + 100;
+	parse_party_and_port(argv, 2, &party, &port);
+	NetIO * io = new NetIO(party==ALICE ? nullptr:"127.0.0.1", port);
+	cout <<"Semi Honest Boolean triples\t"<<double(n)/test_bit_triple<NetIO, SHOTExtension>(io, party, n)*1e6<<" triples/s"<<endl;
+	cout <<"Malicious Boolean triples\t"<<double(n)/test_bit_triple<NetIO, MOTExtension_KOS>(io, party, n)*1e6<<" triples/s"<<endl;
+	delete io;
+}
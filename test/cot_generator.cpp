@@ -0,0 +1,55 @@
+#include "test/test.h"
+#include <iostream>
+using namespace std;
+
+template<typename IO, template<typename>class T>
+double test_generator(IO * io, int party, int64_t length, int max_request) {
+	block * data = new block[length];
+	bool * b = new bool[length];
+	PRG prg(fix_key);
+
+	io->sync();
+	auto start = clock_start();
+	COTGenerator<IO, T> * gen = new COTGenerator<IO, T>(io, party, 1<<18, 1<<20);
+	block delta = gen->delta;
+	for (int64_t i = 0; i < length; ) {
+		uint32_t n;
+		prg.random_data(&n, 4);
+		n = min((int64_t)(n % max_request + 1), length - i);
+		if (party == ALICE)
+			gen->next(data + i, n);
+		else
+			gen->next(data + i, b + i, n);
+		i += n;
+	}
+	double t = time_from(start);
+	delete gen;
+
+	if (party == ALICE) {
+		io->send_block(&delta, 1);
+		io->send_block(data, length);
+	} else {
+		block * b0 = new block[length];
+		io->recv_block(&delta, 1);
+		io->recv_block(b0, length);
+		for (int64_t i = 0; i < length; ++i) {
+			block b1 = xorBlocks(b0[i], delta);
+			if (!block_cmp(&data[i], b[i] ? &b1 : &b0[i], 1))
+				error("COT generator failed!");
+		}
+		delete[] b0;
+	}
+	io->flush();
+	delete[] data;
+	delete[] b;
+	return t;
+}
+
+int main(int argc, char** argv) {
+	int port, party, length = 1<<23;
+	parse_party_and_port(argv, 2, &party, &port);
+	NetIO * io = new NetIO(party==ALICE ? nullptr:"127.0.0.1", port);
+	cout <<"Semi Honest COT Generator\t"<<double(length)/test_generator<NetIO, SHOTExtension>(io, party, length, 1000)*1e6<<" OTps"<<endl;
+	cout <<"Malicious COT Generator\t"<<double(length)/test_generator<NetIO, MOTExtension>(io, party, length, 1000)*1e6<<" OTps"<<endl;
+	delete io;
+}
@@ -0,0 +1,60 @@
+#include "test/test.h"
+#include <iostream>
+using namespace std;
+
+int main(int argc, char** argv) {
+	int port, party, length = 1<<22, chunk = 1<<12;
+	parse_party_and_port(argv, 2, &party, &port);
+	NetIO * io = new NetIO(party==ALICE ? nullptr:"127.0.0.1", port);
+	const char * file = party == ALICE ? "cot_store_alice.bin" : "cot_store_bob.bin";
+	block delta;
+	PRG prg;
+	prg.random_block(&delta, 1);
+
+	auto start = clock_start();
+	SHOTExtension<NetIO> * ot = new SHOTExtension<NetIO>(io);
+	if (party == ALICE) {
+		COTStoreWriter writer(file, COT_STORE_SEND_COT, length, delta);
+		writer.send_cot(ot, length);
+	} else {
+		COTStoreWriter writer(file, COT_STORE_RECV_COT, length);
+		writer.recv_cot(ot, length);
+	}
+	io->flush();
+	cout << "COT Store write\t"<<double(length)/time_from(start)*1e6<<" OTps"<<endl;
+	delete ot;
+
+	COTStore * store = new COTStore(file);
+	const block ** data = new const block*[length/chunk];
+	const bool ** b = new const bool*[length/chunk];
+	start = clock_start();
+	for (int i = 0; i < length/chunk; ++i)
+		data[i] = store->next(chunk, &b[i]);
+	cout << "COT Store read\t"<<double(length)/time_from(start)*1e6<<" OTps"<<endl;
+	if (store->next(1) != nullptr or store->remaining() != 0)
+		error("COT store over-consumed!");
+
+	if (party == ALICE) {
+		io->send_block(&delta, 1);
+		for (int i = 0; i < length/chunk; ++i)
+			io->send_block(data[i], chunk);
+	} else {
+		block * b0 = new block[chunk];
+		io->recv_block(&delta, 1);
+		for (int i = 0; i < length/chunk; ++i) {
+			io->recv_block(b0, chunk);
+			for (int j = 0; j < chunk; ++j) {
+				block b1 = xorBlocks(b0[j], delta);
+				if (!block_cmp(&data[i][j], b[i][j] ? &b1 : &b0[j], 1))
+					error("COT store failed!");
+			}
+		}
+		delete[] b0;
+	}
+	io->flush();
+	delete[] data;
+	delete[] b;
+	delete store;
+	remove(file);
+	delete io;
+}
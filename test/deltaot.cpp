@@ -7,6 +7,63 @@ using namespace emp;
 int size = 1<<24;
 bool * tmp = new bool[256];
 
+double test_tinyot(NetIO * io, int party, int64_t n, int chunk) {
+	int64_t words = (n + 63)/64;
+	uint64_t * bits[3], * bits_o[3];
+	for (int k = 0; k < 3; ++k) {
+		bits[k] = new uint64_t[words];
+		bits_o[k] = new uint64_t[words];
+	}
+	block * mac = new block[3*n], * key = new block[3*n];
+	block * mac_o = new block[3*n], * key_o = new block[3*n];
+	int64_t done = 0;
+
+	auto start = clock_start();
+	TinyOT * tiny = new TinyOT(io, party, 40, chunk);
+	tiny->generate(bits[0], bits[1], bits[2], mac, key, n, [&done](int64_t start, int64_t m) {
+		if (start != done)
+			error("TinyOT chunks out of order");
+		done += m;
+	});
+	double t = time_from(start);
+	if (done != n)
+		error("TinyOT callback missed chunks");
+	if (!getLSB(tiny->Delta))
+		error("TinyOT: LSB(Delta) is not 1");
+
+	block Delta_o;
+	tiny->exchange(&tiny->Delta, &Delta_o, sizeof(block));
+	for (int k = 0; k < 3; ++k)
+		tiny->exchange(bits[k], bits_o[k], words*sizeof(uint64_t));
+	for (int64_t i = 0; i < 3*n; i += 1<<20) {
+		int m = min((int64_t)1<<20, 3*n - i);
+		tiny->exchange(mac+i, mac_o+i, m*sizeof(block));
+		tiny->exchange(key+i, key_o+i, m*sizeof(block));
+	}
+	for (int64_t i = 0; i < n; ++i) {
+		bool v[3];
+		for (int k = 0; k < 3; ++k) {
+			bool mine = TinyOT::get_bit(bits[k], i), theirs = TinyOT::get_bit(bits_o[k], i);
+			v[k] = mine ^ theirs;
+			block m = mine ? xorBlocks(key_o[3*i+k], Delta_o) : key_o[3*i+k];
+			if (!block_cmp(&m, &mac[3*i+k], 1))
+				error("TinyOT: wrong MAC");
+		}
+		if (v[2] != (v[0] & v[1]))
+			error("TinyOT: wrong AND triple");
+	}
+	delete tiny;
+	for (int k = 0; k < 3; ++k) {
+		delete[] bits[k];
+		delete[] bits_o[k];
+	}
+	delete[] mac;
+	delete[] key;
+	delete[] mac_o;
+	delete[] key_o;
+	return t;
+}
+
 int main(int argc, char** argv) {
 	int port, party;
 	parse_party_and_port(argv, &party, &port);
@@ -51,5 +108,11 @@ int main(int argc, char** argv) {
 			}
 		}
 	}
+	delete abit;
+	delete[] t1;
+	delete[] bb;
+
+	cout <<"TinyOT AND triples (chunks of 2^16)\t"<<double(100000)/test_tinyot(io, party, 100000, 1<<16)*1e6<<" triples/s"<<endl;
+	cout <<"TinyOT AND triples\t"<<double(1<<20)/test_tinyot(io, party, 1<<20, 1<<20)*1e6<<" triples/s"<<endl;
 	return 0;
 }
@@ -0,0 +1,56 @@
+#include "test/test.h"
+#include <iostream>
+using namespace std;
+
+template<typename IO>
+double test_kkot(IO * io, int party, int N, int length, bool random) {
+	block * data = new block[(int64_t)length*N], *r = new block[length];
+	uint8_t * b = new uint8_t[length];
+	PRG prg(fix_key);
+	prg.random_block(data, length*N);
+	prg.random_data(b, length);
+	for(int i = 0; i < length; ++i)
+		b[i] %= N;
+
+	io->sync();
+	auto start = clock_start();
+	NOTExtension_KK<IO> * ot = new NOTExtension_KK<IO>(io, N);
+	if (party == ALICE) {
+		if (random) ot->send_rot(data, length);
+		else ot->send(data, length);
+	} else {
+		if (random) ot->recv_rot(r, b, length);
+		else ot->recv(r, b, length);
+	}
+	io->flush();
+	long long t = time_from(start);
+	if (random) {
+		if (party == ALICE)
+			io->send_block(data, length*N);
+		else
+			io->recv_block(data, length*N);
+	}
+	if (party == BOB) {
+		for(int i = 0; i < length; ++i)
+			if (!block_cmp(&r[i], &data[(int64_t)i*N+b[i]], 1))
+				error("1-out-of-N OT failed!");
+	}
+	io->flush();
+	delete ot;
+	delete[] data;
+	delete[] r;
+	delete[] b;
+	return t;
+}
+
+int main(int argc, char** argv) {
+	int port, party;
+	parse_party_and_port(argv, 2, &party, &port);
+	NetIO * io = new NetIO(party==ALICE ? nullptr:"127.0.0.1", port);
+	for (int N : {2, 4, 16, 256}) {
+		int length = min(1<<22, (1<<24)/N);
+		cout <<"1-out-of-"<<N<<" OT Extension\t"<<double(length)/test_kkot<NetIO>(io, party, N, length, false)*1e6<<" OTps"<<endl;
+		cout <<"1-out-of-"<<N<<" ROT Extension\t"<<double(length)/test_kkot<NetIO>(io, party, N, length, true)*1e6<<" OTps"<<endl;
+	}
+	delete io;
+}
@@ -0,0 +1,57 @@
+#include "test/test.h"
+#include <iostream>
+using namespace std;
+
+template<typename IO, template<typename> class T>
+double test_long_ot(IO * io, int party, int n, int64_t max_length) {
+	int64_t * lengths = new int64_t[n];
+	int64_t total = 0;
+	PRG prg(fix_key);
+	for (int i = 0; i < n; ++i) {
+		uint32_t x;
+		prg.random_data(&x, sizeof(x));
+		lengths[i] = 1 + x % max_length;
+		total += lengths[i];
+	}
+	uint8_t * data0 = new uint8_t[total], * data1 = new uint8_t[total], * r = new uint8_t[total];
+	bool * b = new bool[n];
+	prg.random_data(data0, total);
+	prg.random_data(data1, total);
+	prg.random_bool(b, n);
+
+	io->sync();
+	auto start = clock_start();
+	LongOT<IO, T> * ot = new LongOT<IO, T>(io);
+	if (party == ALICE)
+		ot->send(data0, data1, lengths, n);
+	else
+		ot->recv(r, b, lengths, n);
+	io->flush();
+	long long t = time_from(start);
+	if (party == BOB) {
+		int64_t offset = 0;
+		for (int i = 0; i < n; ++i) {
+			const uint8_t * m = b[i] ? data1 : data0;
+			if (memcmp(r + offset, m + offset, lengths[i]) != 0)
+				error("long OT failed!");
+			offset += lengths[i];
+		}
+	}
+	delete ot;
+	delete[] lengths;
+	delete[] data0;
+	delete[] data1;
+	delete[] r;
+	delete[] b;
+	return t;
+}
+
+int main(int argc, char** argv) {
+	int port, party, n = 1<<14;
+	parse_party_and_port(argv, 2, &party, &port);
+	NetIO * io = new NetIO(party==ALICE ? nullptr:"127.0.0.1", port);
+	cout <<"Semi Honest Long OT (up to 4KB)\t"<<double(n)/test_long_ot<NetIO, SHOTExtension>(io, party, n, 4096)*1e6<<" OTps"<<endl;
+	cout <<"Malicious Long OT (up to 4KB)\t"<<double(n)/test_long_ot<NetIO, MOTExtension_KOS>(io, party, n, 4096)*1e6<<" OTps"<<endl;
+	cout <<"Semi Honest Long OT (up to 1MB)\t"<<double(64)/test_long_ot<NetIO, SHOTExtension>(io, party, 64, 1<<20)*1e6<<" OTps"<<endl;
+	delete io;
+}
@@ -2,6 +2,38 @@
 #include "test/test.h"
 using namespace std;
 
+template<typename IO>
+class MOTExtension_KOS2: public MOTExtension_KOS<IO> { public:
+	MOTExtension_KOS2(IO * io) : MOTExtension_KOS<IO>(io, false, 40, 2) {}
+};
+
+template<typename IO>
+class MOTExtension_ALSZ2: public MOTExtension_ALSZ<IO> { public:
+	MOTExtension_ALSZ2(IO * io) : MOTExtension_ALSZ<IO>(io, false, 40, 2) {}
+};
+
+// the ALSZ row transposition against a bit-by-bit one, for rows wider than 128 bits
+void test_alsz_transpose(int rows, int64_t cols) {
+	int w = (rows+127)/128;
+	int64_t stride = cols/8 + 16;
+	uint8_t * in = new uint8_t[rows*stride];
+	block * out = new block[cols*w];
+	PRG prg(fix_key);
+	prg.random_data(in, rows*stride);
+	memset(out, 0, cols*w*sizeof(block));
+	MOTExtension_ALSZ<NetIO>::transpose(out, w, in, rows, stride, cols);
+	for (int64_t c = 0; c < cols; ++c) {
+		const uint8_t * row = (const uint8_t *)(out + c*w);
+		for (int r = 0; r < w*128; ++r) {
+			bool want = r < rows and ((in[r*stride + c/8] >> (c%8)) & 1);
+			if (((row[r/8] >> (r%8)) & 1) != want)
+				error("ALSZ transpose failed");
+		}
+	}
+	delete[] in;
+	delete[] out;
+}
+
 template<typename IO, template<typename>class T>
 double test_cot_mal(NetIO * io, int party, int length) {
 	block *b0 = new block[length], *r = new block[length];
@@ -45,13 +77,129 @@ double test_cot_mal(NetIO * io, int party, int length) {
 	return t;
 }
 
+// calls COTs and ROTs of `length` each under one deferred check
+template<typename IO>
+double test_deferred(IO * io, int party, int calls, int length, int64_t budget) {
+	int64_t n = (int64_t)calls * length;
+	block *d0 = new block[n], *d1 = new block[n], *r = new block[n];
+	bool *b = new bool[n];
+	block delta;
+	PRG prg(fix_key);
+	prg.random_block(&delta, 1);
+	prg.random_bool(b, n);
+
+	io->sync();
+	auto start = clock_start();
+	MOTExtension_KOS<IO> * ot = new MOTExtension_KOS<IO>(io);
+	ot->set_deferred(budget);
+	for (int c = 0; c < calls; ++c) {
+		int64_t o = (int64_t)c * length;
+		if (party == ALICE) {
+			if (c % 2 == 0) ot->send_cot(d0+o, delta, length);
+			else ot->send_rot(d0+o, d1+o, length);
+		} else {
+			if (c % 2 == 0) ot->recv_cot(r+o, b+o, length);
+			else ot->recv_rot(r+o, b+o, length);
+		}
+	}
+	ot->verify();
+	io->flush();
+	long long t = time_from(start);
+	for (int c = 0; c < calls; c += 2)
+		for (int i = c * length; i < (c+1) * length; ++i)
+			d1[i] = xorBlocks(d0[i], delta);
+	if (party == ALICE) {
+		io->send_block(d0, n);
+		io->send_block(d1, n);
+	} else {
+		block * e0 = new block[n], * e1 = new block[n];
+		io->recv_block(e0, n);
+		io->recv_block(e1, n);
+		for (int64_t i = 0; i < n; ++i)
+			if (!block_cmp(&r[i], b[i] ? &e1[i] : &e0[i], 1))
+				error("deferred check: wrong output");
+		delete[] e0;
+		delete[] e1;
+	}
+	io->flush();
+	delete ot;
+	delete[] d0;
+	delete[] d1;
+	delete[] r;
+	delete[] b;
+	return t;
+}
+
+// committing OT: BOB opens the messages it did not choose, `chunk` at a time
+template<typename IO>
+double test_open(IO * io, int party, int length, int chunk) {
+	block *d0 = new block[length], *d1 = new block[length], *r = new block[length];
+	bool *b = new bool[length];
+	PRG prg(fix_key);
+	prg.random_block(d0, length);
+	prg.random_block(d1, length);
+	prg.random_bool(b, length);
+
+	io->sync();
+	auto start = clock_start();
+	MOTExtension_KOS<IO> * ot = new MOTExtension_KOS<IO>(io, true);
+	// an earlier call, so the opened one starts mid-stream
+	if (party == ALICE) {
+		ot->send(d1, d0, 1000);
+		ot->send(d0, d1, length);
+		ot->open();
+		// recv -> open again, through the whole-call open
+		ot->send(d1, d0, 1000);
+		ot->open();
+	} else {
+		ot->recv(r, b, 1000);
+		ot->recv(r, b, length);
+		for (int i = 0; i < length; ++i)
+			if (!block_cmp(&r[i], b[i] ? &d1[i] : &d0[i], 1))
+				error("committing OT: wrong output");
+		for (int i = 0; i < length; i += chunk) {
+			int n = min(chunk, length - i);
+			ot->open_range(r + i, i, i + n);
+		}
+		for (int i = 0; i < length; ++i)
+			if (!block_cmp(&r[i], b[i] ? &d0[i] : &d1[i], 1))
+				error("committing OT: wrong opening");
+		ot->recv(r, b, 1000);
+		ot->open(r, b, 1000);
+		for (int i = 0; i < 1000; ++i)
+			if (!block_cmp(&r[i], b[i] ? &d1[i] : &d0[i], 1))
+				error("committing OT: wrong second opening");
+	}
+	io->flush();
+	long long t = time_from(start);
+	delete ot;
+	delete[] d0;
+	delete[] d1;
+	delete[] r;
+	delete[] b;
+	return t;
+}
+
 int main(int argc, char** argv) {
 	int port, party, length = 1<<24;
 	parse_party_and_port(argv, 2, &party, &port);
 	NetIO * io = new NetIO(party==ALICE ? nullptr:"127.0.0.1", port);
 	cout <<"COOT\t"<<10000.0/test_ot<NetIO, OTCO>(io, party, 10000)*1e6<<" OTps"<<endl;
 	cout <<"Malicious OT Extension\t"<<double(length)/test_ot<NetIO, MOTExtension>(io, party, length)*1e6<<" OTps"<<endl;
+	cout <<"Malicious OT Extension (ALSZ)\t"<<double(length)/test_ot<NetIO, MOTExtension_ALSZ>(io, party, length)*1e6<<" OTps"<<endl;
+	cout <<"Malicious OT Extension (ALSZ, 2-thread check)\t"<<double(length)/test_ot<NetIO, MOTExtension_ALSZ2>(io, party, length)*1e6<<" OTps"<<endl;
+	test_alsz_transpose(240, 1<<12);
+	cout <<"Malicious OT Extension (2-thread check)\t"<<double(length)/test_ot<NetIO, MOTExtension_KOS2>(io, party, length)*1e6<<" OTps"<<endl;
+	cout <<"Malicious COT/ROT, 256 calls of 2^14, one deferred check\t"<<double(1<<22)/test_deferred<NetIO>(io, party, 256, 1<<14, 1LL<<40)*1e6<<" OTps"<<endl;
+	cout <<"Malicious COT/ROT, 256 calls of 2^14, check per 2^20\t"<<double(1<<22)/test_deferred<NetIO>(io, party, 256, 1<<14, 1<<20)*1e6<<" OTps"<<endl;
+	cout <<"Malicious COT/ROT, 256 calls of 2^14, check per call\t"<<double(1<<22)/test_deferred<NetIO>(io, party, 256, 1<<14, 0)*1e6<<" OTps"<<endl;
 	cout <<"Malicious COT Extension\t"<<double(length)/test_cot_mal<NetIO, MOTExtension>(io, party, length)*1e6<<" OTps"<<endl;
+	cout <<"Malicious COT Extension (arbitrary correlation, vector<function>)\t"<<double(length)/test_cot_fs<NetIO, MOTExtension>(io, party, length)*1e6<<" OTps"<<endl;
+	cout <<"Malicious COT Extension (arbitrary correlation, singlefunction)\t"<<double(length)/test_cot_f<NetIO, MOTExtension>(io, party, length)*1e6<<" OTps"<<endl;
+	cout <<"Malicious COT Extension (arbitrary correlation, templated-singlefunction)\t"<<double(length)/test_cot_ft<NetIO, MOTExtension>(io, party, length)*1e6<<" OTps"<<endl;
+	cout <<"Malicious COT Extension (2 x 64-bit Integer addition)\t"<<double(length)/test_cot_add_deltas<NetIO, MOTExtension>(io, party, length)*1e6<<" OTps"<<endl;
+	cout <<"Committing OT Extension, opened in ranges of 100000\t"<<double(length)/test_open<NetIO>(io, party, length, 100000)*1e6<<" OTps"<<endl;
+	cout <<"Malicious garbling labels (wire-id scatter)\t"<<double(length)/test_labels<NetIO, MOTExtension>(io, party, length)*1e6<<" OTps"<<endl;
    cout <<"Malicious ROT Extension\t"<<double(length)/test_rot<NetIO, MOTExtension>(io, party, length)*1e6<<" OTps"<<endl;
 	delete io;
 }
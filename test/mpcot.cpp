@@ -0,0 +1,57 @@
+#include "test/test.h"
+#include <iostream>
+using namespace std;
+
+template<typename IO, template<typename> class T>
+double test_mpcot(IO * io, int party, int t, int h, int threads, bool with_delta) {
+	int64_t n = (int64_t)t << h;
+	block * out = new block[n], * other = new block[n];
+	int * alpha = new int[t];
+	block delta;
+	PRG prg(fix_key);
+	prg.random_block(&delta, 1);
+	prg.random_data(alpha, t*sizeof(int));
+	for (int j = 0; j < t; ++j)
+		alpha[j] &= (1 << h) - 1;
+
+	io->sync();
+	auto start = clock_start();
+	MPCOT<IO, T> * mpcot = new MPCOT<IO, T>(io, h, threads);
+	if (party == ALICE)
+		mpcot->send(out, t, with_delta ? &delta : nullptr);
+	else
+		mpcot->recv(out, t, alpha, with_delta);
+	io->flush();
+	long long time = time_from(start);
+	if (party == ALICE) {
+		io->send_block(out, n);
+		io->flush();
+	} else {
+		io->recv_block(other, n);
+		for (int j = 0; j < t; ++j)
+			for (int x = 0; x < (1 << h); ++x) {
+				int64_t i = ((int64_t)j << h) + x;
+				block expect = other[i];
+				if (x == alpha[j])
+					expect = with_delta ? xorBlocks(expect, delta) : zero_block();
+				if (!block_cmp(&out[i], &expect, 1))
+					error("MPCOT failed!");
+			}
+	}
+	delete mpcot;
+	delete[] out;
+	delete[] other;
+	delete[] alpha;
+	return time;
+}
+
+int main(int argc, char** argv) {
+	int port, party, t = 1280, h = 13;
+	parse_party_and_port(argv, 2, &party, &port);
+	NetIO * io = new NetIO(party==ALICE ? nullptr:"127.0.0.1", port);
+	double n = double(t) * (1 << h);
+	cout <<"Semi Honest MPCOT\t"<<n/test_mpcot<NetIO, SHOTExtension>(io, party, t, h, 1, true)*1e6<<" leaves/s"<<endl;
+	cout <<"Semi Honest MPCOT (2 threads)\t"<<n/test_mpcot<NetIO, SHOTExtension>(io, party, t, h, 2, true)*1e6<<" leaves/s"<<endl;
+	cout <<"Malicious-ROT punctured PRF\t"<<n/test_mpcot<NetIO, MOTExtension_KOS>(io, party, t, h, 1, false)*1e6<<" leaves/s"<<endl;
+	delete io;
+}
@@ -0,0 +1,49 @@
+#include "test/test.h"
+#include <iostream>
+#include <thread>
+using namespace std;
+
+const int threads = 8, requests = 2000, max_length = 64;
+
+template<typename IO, template<typename>class T>
+double test_coalescer(IO * io, int party) {
+	io->sync();
+	auto start = clock_start();
+	OTCoalescer<IO, T> * coalescer = new OTCoalescer<IO, T>(io, party, 50);
+	vector<thread> pool;
+	for (int t = 0; t < threads; ++t) {
+		pool.push_back(thread([coalescer, party, t]() {
+			block b0[max_length], b1[max_length], r[max_length];
+			bool b[max_length];
+			for (int i = 0; i < requests; ++i) {
+				uint64_t tag = t * requests + i;
+				PRG prg(fix_key, tag);
+				int length = 1 + tag % max_length;
+				prg.random_block(b0, length);
+				prg.random_block(b1, length);
+				prg.random_bool(b, length);
+				if (party == ALICE) {
+					coalescer->send(tag, b0, b1, length).wait();
+				} else {
+					coalescer->recv(tag, r, b, length).wait();
+					for (int j = 0; j < length; ++j)
+						if (!block_cmp(&r[j], b[j] ? &b1[j] : &b0[j], 1))
+							error("OT coalescer failed!");
+				}
+			}
+		}));
+	}
+	for (auto & th : pool)
+		th.join();
+	delete coalescer;
+	return time_from(start);
+}
+
+int main(int argc, char** argv) {
+	int port, party;
+	parse_party_and_port(argv, 2, &party, &port);
+	NetIO * io = new NetIO(party==ALICE ? nullptr:"127.0.0.1", port);
+	cout <<"Coalesced Semi Honest OT Extension\t"<<double(threads*requests)/test_coalescer<NetIO, SHOTExtension>(io, party)*1e6<<" requests/s"<<endl;
+	cout <<"Coalesced Malicious OT Extension\t"<<double(threads*requests)/test_coalescer<NetIO, MOTExtension>(io, party)*1e6<<" requests/s"<<endl;
+	delete io;
+}
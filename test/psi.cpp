@@ -0,0 +1,79 @@
+#include "test/test.h"
+#include <iostream>
+using namespace std;
+
+template<typename IO>
+void test_oprf(IO * io, int party, int length) {
+	block * x = new block[length], * out = new block[length], * other = new block[length];
+	int64_t * id = new int64_t[length];
+	PRG prg(fix_key);
+	prg.random_block(x, length);
+	OPRF_KKRT<IO> * oprf = new OPRF_KKRT<IO>(io);
+	if (party == ALICE) {
+		oprf->send(length);
+		for (int i = 0; i < length; ++i)
+			id[i] = i;
+		oprf->eval(out, x, id, length);
+		io->send_block(out, length);
+		// a different input must not give the receiver's value
+		x[0] = xorBlocks(x[0], makeBlock(0, 1));
+		oprf->eval(out, x, id, 1);
+		io->send_block(out, 1);
+	} else {
+		oprf->recv(out, x, length);
+		io->recv_block(other, length);
+		if (!block_cmp(out, other, length))
+			error("OPRF failed!");
+		io->recv_block(other, 1);
+		if (block_cmp(out, other, 1))
+			error("OPRF collision!");
+	}
+	io->flush();
+	delete oprf;
+	delete[] x;
+	delete[] out;
+	delete[] other;
+	delete[] id;
+}
+
+// BOB holds items [0, n), ALICE [n/2, 3n/2)
+template<typename IO>
+double test_psi(IO * io, int party, int64_t n, int threads) {
+	block * set = new block[n];
+	int64_t * result = new int64_t[n];
+	for (int64_t i = 0; i < n; ++i)
+		set[i] = makeBlock(0x5053492d, party == ALICE ? i + n/2 : i);
+
+	io->sync();
+	auto start = clock_start();
+	PSI_KKRT<IO> * psi = new PSI_KKRT<IO>(io, party, threads);
+	int64_t cnt = 0;
+	if (party == ALICE)
+		psi->send(set, n, n);
+	else
+		cnt = psi->recv(result, set, n, n);
+	io->flush();
+	long long t = time_from(start);
+	if (party == BOB) {
+		if (cnt != n - n/2)
+			error("PSI: wrong intersection size");
+		for (int64_t i = 0; i < cnt; ++i)
+			if (result[i] != n/2 + i)
+				error("PSI failed!");
+	}
+	delete psi;
+	delete[] set;
+	delete[] result;
+	return t;
+}
+
+int main(int argc, char** argv) {
+	int port, party;
+	parse_party_and_port(argv, 2, &party, &port);
+	NetIO * io = new NetIO(party==ALICE ? nullptr:"127.0.0.1", port);
+	test_oprf<NetIO>(io, party, 100000);
+	for (int64_t n : {1<<12, 1<<16, 1<<20})
+		cout <<"KKRT PSI, n = "<<n<<"\t"<<double(n)/test_psi<NetIO>(io, party, n, 1)*1e6<<" items/s"<<endl;
+	cout <<"KKRT PSI, n = "<<(1<<20)<<", 2 threads\t"<<double(1<<20)/test_psi<NetIO>(io, party, 1<<20, 2)*1e6<<" items/s"<<endl;
+	delete io;
+}
@@ -2,17 +2,47 @@
 #include <iostream>
 using namespace std;
 
+template<typename IO, int k>
+class SoftSpokenOT: public SHOTExtension<IO> { public:
+	SoftSpokenOT(IO * io) : SHOTExtension<IO>(io, k) {}
+};
+template<typename IO> using SoftSpoken2 = SoftSpokenOT<IO, 2>;
+template<typename IO> using SoftSpoken4 = SoftSpokenOT<IO, 4>;
+template<typename IO> using SoftSpoken8 = SoftSpokenOT<IO, 8>;
+
 int main(int argc, char** argv) {
 	int length = 1<<24, port, party;
   parse_party_and_port(argv, 2, &party, &port);
 	NetIO * io = new NetIO(party==ALICE ? nullptr:"127.0.0.1", port);
 	cout << "NPOT\t"<<10000.0/test_ot<NetIO, OTNP>(io, party, 10000)*1e6<<" OTps"<<endl;
 	cout << "Semi Honest OT Extension\t"<<double(length)/test_ot<NetIO, SHOTExtension>(io, party, length)*1e6<<" OTps"<<endl;
+	cout << "SoftSpoken OT Extension (k=2)\t"<<double(length)/test_ot<NetIO, SoftSpoken2>(io, party, length)*1e6<<" OTps"<<endl;
+	cout << "SoftSpoken OT Extension (k=4)\t"<<double(length)/test_ot<NetIO, SoftSpoken4>(io, party, length)*1e6<<" OTps"<<endl;
+	cout << "SoftSpoken COT Extension (k=8)\t"<<double(length)/test_cot<NetIO, SoftSpoken8>(io, party, length)*1e6<<" OTps"<<endl;
+	for (int l : {1, 8, 64})
+		cout << "Semi Honest "<<l<<"-bit OT Extension\t"<<double(length)/test_ot_bits<NetIO, SHOTExtension>(io, party, length, l)*1e6<<" OTps"<<endl;
 	cout << "Semi Honest COT Extension\t"<<double(length)/test_cot<NetIO, SHOTExtension>(io, party, length)*1e6<<" OTps"<<endl;
   cout << "Semi Honest COT Extension (arbitrary correlation, vector<function>)\t"<<double(length)/test_cot_fs<NetIO, SHOTExtension>(io, party, length)*1e6<<" OTps"<<endl;
   cout << "Semi Honest COT Extension (arbitrary correlation, singlefunction)\t"<<double(length)/test_cot_f<NetIO, SHOTExtension>(io, party, length)*1e6<<" OTps"<<endl;
   cout << "Semi Honest COT Extension (arbitrary correlation, templated-singlefunction)\t"<<double(length)/test_cot_ft<NetIO, SHOTExtension>(io, party, length)*1e6<<" OTps"<<endl;
   cout << "Semi Honest COT Extension (2 x 64-bit Integer addition)\t"<<double(length)/test_cot_add_deltas<NetIO, SHOTExtension>(io, party, length)*1e6<<" OTps"<<endl;
+	cout << "Semi Honest OLE (2^61-1)\t"<<double(length/64)/test_prime_ole<NetIO, Mersenne61>(io, party, length/64)*1e6<<" OLEps"<<endl;
+	cout << "Semi Honest OLE (2^64-59)\t"<<double(length/64)/test_prime_ole<NetIO, Prime64>(io, party, length/64)*1e6<<" OLEps"<<endl;
+	{
+		block * deltas = new block[length];
+		PRG prg(fix_key);
+		prg.random_block(deltas, length);
+		cout << "Semi Honest COT Extension (xor policy, per-OT delta)\t"<<double(length)/test_cot_p<NetIO, SHOTExtension>(io, party, length, XorCorrelation(deltas))*1e6<<" OTps"<<endl;
+		cout << "Semi Honest COT Extension (4 x 32-bit addition policy)\t"<<double(length)/test_cot_p<NetIO, SHOTExtension>(io, party, length, AddCorrelation<uint32_t>(deltas))*1e6<<" OTps"<<endl;
+		cout << "Semi Honest COT Extension (2 x 64-bit addition policy)\t"<<double(length)/test_cot_p<NetIO, SHOTExtension>(io, party, length, AddCorrelation<uint64_t>(deltas))*1e6<<" OTps"<<endl;
+		cout << "Semi Honest COT Extension (2 x 64-bit affine policy)\t"<<double(length)/test_cot_p<NetIO, SHOTExtension>(io, party, length, AffineCorrelation(0x9e3779b97f4a7c15ULL, deltas))*1e6<<" OTps"<<endl;
+		delete[] deltas;
+	}
+	cout << "Semi Honest COT Extension (8-bit ring)\t"<<double(length)/test_cot_trunc<NetIO, SHOTExtension, uint8_t>(io, party, length)*1e6<<" OTps"<<endl;
+	cout << "Semi Honest COT Extension (16-bit ring)\t"<<double(length)/test_cot_trunc<NetIO, SHOTExtension, uint16_t>(io, party, length)*1e6<<" OTps"<<endl;
+	cout << "Semi Honest COT Extension (32-bit ring)\t"<<double(length)/test_cot_trunc<NetIO, SHOTExtension, uint32_t>(io, party, length)*1e6<<" OTps"<<endl;
+	cout << "Semi Honest COT Extension (64-bit ring)\t"<<double(length)/test_cot_trunc<NetIO, SHOTExtension, uint64_t>(io, party, length)*1e6<<" OTps"<<endl;
+	cout << "Semi Honest garbling labels (wire-id scatter)\t"<<double(length)/test_labels<NetIO, SHOTExtension>(io, party, length)*1e6<<" OTps"<<endl;
 	cout << "Semi Honest ROT Extension\t"<<double(length)/test_rot<NetIO, SHOTExtension>(io, party, length)*1e6<<" OTps"<<endl;
 	delete io;
 }
@@ -0,0 +1,58 @@
+#include "test/test.h"
+#include <iostream>
+using namespace std;
+
+template<typename IO, template<typename> class T>
+double test_silent_cot(IO * io, int party, int64_t length, bool check, int threads = 1) {
+	const int64_t chunk = 1<<22;
+	block * data = new block[chunk], * data0 = new block[chunk];
+	bool * b = new bool[chunk];
+	io->sync();
+	auto start = clock_start();
+	SilentCOT<IO, T> * ot = new SilentCOT<IO, T>(io, party, 1280, 13, 452000, threads);
+	long long t = time_from(start);
+	for (int64_t i = 0; i < length; i += chunk) {
+		int64_t len = min(chunk, length - i);
+		auto s = clock_start();
+		if (party == ALICE)
+			ot->send_cot(data, len);
+		else
+			ot->recv_cot(data, b, len);
+		t += time_from(s);
+		if (!check)
+			continue;
+		if (party == ALICE) {
+			io->send_block(&ot->delta, 1);
+			io->send_block(data, len);
+			io->flush();
+		} else {
+			block delta;
+			io->recv_block(&delta, 1);
+			io->recv_block(data0, len);
+			for (int64_t j = 0; j < len; ++j) {
+				block m1 = xorBlocks(data0[j], delta);
+				if (!block_cmp(&data[j], b[j] ? &m1 : &data0[j], 1))
+					error("silent COT failed!");
+			}
+		}
+	}
+	io->flush();
+	delete ot;
+	delete[] data;
+	delete[] data0;
+	delete[] b;
+	return t;
+}
+
+int main(int argc, char** argv) {
+	int port, party;
+	parse_party_and_port(argv, 2, &party, &port);
+	NetIO * io = new NetIO(party==ALICE ? nullptr:"127.0.0.1", port);
+	test_silent_cot<NetIO, SHOTExtension>(io, party, 1<<25, true);
+	test_silent_cot<NetIO, MOTExtension_KOS>(io, party, 1<<23, true);
+	test_silent_cot<NetIO, SHOTExtension>(io, party, 1<<23, true, 2);
+	cout <<"Tests passed.\n";
+	for (int64_t length : {10000000LL, 100000000LL})
+		cout <<"Silent COT ("<<length<<")\t"<<double(length)/test_silent_cot<NetIO, SHOTExtension>(io, party, length, false)*1e6<<" OTps"<<endl;
+	delete io;
+}
@@ -135,6 +135,40 @@ double test_bit_ot(IO *io, int party, int length) {
   return t;
 }
 
+template <typename IO, template <typename> class T>
+double test_ot_bits(IO *io, int party, int length, int l) {
+  uint64_t *b0 = new uint64_t[length], *b1 = new uint64_t[length],
+           *r = new uint64_t[length];
+  const uint64_t mask = l == 64 ? ~0ULL : (1ULL << l) - 1;
+  PRG prg(fix_key);
+  prg.random_data(b0, length * sizeof(uint64_t));
+  prg.random_data(b1, length * sizeof(uint64_t));
+  bool *b = new bool[length];
+  prg.random_bool(b, length);
+
+  io->sync();
+  auto start = clock_start();
+  T<IO> *ot = new T<IO>(io);
+  if (party == ALICE) {
+    ot->send_bits(b0, b1, length, l);
+  } else {
+    ot->recv_bits(r, b, length, l);
+  }
+  io->flush();
+  long long t = time_from(start);
+  if (party == BOB) {
+    for (int i = 0; i < length; ++i)
+      if (r[i] != ((b[i] ? b1[i] : b0[i]) & mask))
+        error("bit OT failed!");
+  }
+  delete ot;
+  delete[] b0;
+  delete[] b1;
+  delete[] r;
+  delete[] b;
+  return t;
+}
+
 template <typename IO, template <typename> class T>
 double test_cot(IO *io, int party, int length) {
   block *b0 = new block[length], *r = new block[length];
@@ -327,6 +361,79 @@ double test_cot_f(NetIO *io, int party, int length) {
   return t;
 }
 
+template <typename IO, template <typename> class T, typename P>
+double test_cot_p(IO *io, int party, int length, const P &policy) {
+  block *b0 = new block[length], *r = new block[length], *m1 = new block[length];
+  bool *b = new bool[length];
+  PRG prg(fix_key);
+  prg.random_bool(b, length);
+
+  io->sync();
+  auto start = clock_start();
+  T<IO> *ot = new T<IO>(io);
+  if (party == ALICE) {
+    ot->send_cot_p(b0, policy, length);
+  } else {
+    ot->recv_cot(r, b, length);
+  }
+  io->flush();
+  long long t = time_from(start);
+  if (party == ALICE) {
+    io->send_block(b0, length);
+  } else if (party == BOB) {
+    io->recv_block(b0, length);
+    policy(m1, b0, 0, length);
+    for (int i = 0; i < length; ++i) {
+      if (!block_cmp(&r[i], b[i] ? &m1[i] : &b0[i], 1))
+        error("COT failed!\n");
+    }
+  }
+  io->flush();
+  delete ot;
+  delete[] b0;
+  delete[] r;
+  delete[] m1;
+  delete[] b;
+  return t;
+}
+
+template <typename IO, template <typename> class T, typename W>
+double test_cot_trunc(IO *io, int party, int length) {
+  W *b0 = new W[length], *r = new W[length], *deltas = new W[length];
+  bool *b = new bool[length];
+  PRG prg(fix_key);
+  prg.random_data(deltas, length * sizeof(W));
+  prg.random_bool(b, length);
+
+  io->sync();
+  auto start = clock_start();
+  T<IO> *ot = new T<IO>(io);
+  if (party == ALICE) {
+    ot->send_cot_trunc(b0, deltas, length);
+  } else {
+    ot->recv_cot_trunc(r, b, length);
+  }
+  io->flush();
+  long long t = time_from(start);
+  if (party == ALICE) {
+    io->send_data(b0, length * sizeof(W));
+  } else if (party == BOB) {
+    io->recv_data(b0, length * sizeof(W));
+    for (int i = 0; i < length; ++i) {
+      W m = b[i] ? (W)(b0[i] + deltas[i]) : b0[i];
+      if (r[i] != m)
+        error("COT failed!\n");
+    }
+  }
+  io->flush();
+  delete ot;
+  delete[] b0;
+  delete[] r;
+  delete[] deltas;
+  delete[] b;
+  return t;
+}
+
 template <typename IO, template <typename> class T>
 double test_cot_add_deltas(NetIO *io, int party, int length) {
   block *b0 = new block[length], *r = new block[length];
@@ -376,6 +483,102 @@ double test_cot_add_deltas(NetIO *io, int party, int length) {
   return t;
 }
 
+template <typename IO, typename F>
+double test_prime_ole(IO *io, int party, int length) {
+  uint64_t *a = new uint64_t[length], *b = new uint64_t[length];
+  uint64_t *x = new uint64_t[length], *v = new uint64_t[length];
+  PRG prg(fix_key);
+  prg.random_data(a, length * sizeof(uint64_t));
+  prg.random_data(x, length * sizeof(uint64_t));
+  for (int i = 0; i < length; ++i) {
+    a[i] = F::reduce(a[i]);
+    x[i] = F::reduce(x[i]);
+  }
+
+  io->sync();
+  auto start = clock_start();
+  PrimeOLE<IO, F> *ole = new PrimeOLE<IO, F>(io);
+  if (party == ALICE) {
+    ole->send(a, b, length);
+  } else {
+    ole->recv(x, v, length);
+  }
+  io->flush();
+  long long t = time_from(start);
+  if (party == ALICE) {
+    io->send_data(b, length * sizeof(uint64_t));
+  } else if (party == BOB) {
+    io->recv_data(b, length * sizeof(uint64_t));
+    for (int i = 0; i < length; ++i)
+      if (v[i] != F::add(F::mul(a[i], x[i]), b[i]))
+        error("OLE failed!");
+  }
+  io->flush();
+  delete ole;
+  delete[] a;
+  delete[] b;
+  delete[] x;
+  delete[] v;
+  return t;
+}
+
+template <typename IO, template <typename> class T>
+double test_labels(IO *io, int party, int length) {
+  int wires = 2 * length;
+  block *labels = new block[wires], *other = new block[wires];
+  bool *values = new bool[wires];
+  int *ids = new int[length];
+  block delta;
+  PRG prg(fix_key);
+  prg.random_block(&delta, 1);
+  delta = _mm_or_si128(delta, makeBlock(0, 1));
+  prg.random_bool(values, wires);
+  for (int i = 0; i < length; ++i)
+    ids[i] = 2 * i + 1;
+  for (int i = length - 1; i > 0; --i) {
+    uint32_t j;
+    prg.random_data(&j, sizeof(j));
+    std::swap(ids[i], ids[j % (i + 1)]);
+  }
+  int ready = 0;
+  auto cb = [&ready](int start, int n) {
+    if (start != ready)
+      error("label chunks out of order");
+    ready += n;
+  };
+
+  io->sync();
+  auto start = clock_start();
+  T<IO> *ot = new T<IO>(io);
+  if (party == ALICE) {
+    ot->send_labels(labels, ids, delta, length, 1 << 18, cb);
+  } else {
+    ot->recv_labels(labels, ids, values, length, 1 << 18, cb);
+  }
+  io->flush();
+  long long t = time_from(start);
+  if (ready != length)
+    error("label callback missed chunks");
+  if (party == ALICE) {
+    io->send_block(labels, wires);
+  } else if (party == BOB) {
+    io->recv_block(other, wires);
+    for (int i = 0; i < length; ++i) {
+      int w = ids[i];
+      block expect = values[w] ? xorBlocks(other[w], delta) : other[w];
+      if (!block_cmp(&labels[w], &expect, 1))
+        error("labels failed!");
+    }
+  }
+  io->flush();
+  delete ot;
+  delete[] labels;
+  delete[] other;
+  delete[] values;
+  delete[] ids;
+  return t;
+}
+
 template <typename IO, template <typename> class T>
 double test_rot(IO *io, int party, int length) {
   block *b0 = new block[length], *r = new block[length];